@@ -0,0 +1,547 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+    #error "rmx/async.hpp requires C++20 coroutines"
+#endif
+
+#include <rmx/detail/spin_lock.hpp>
+#include <rmx/rmx.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! A suspended coroutine waiting for an async lock
+struct AsyncWaiter
+{
+    std::coroutine_handle<> m_handle;
+    AsyncWaiter* m_next = nullptr;
+    bool m_exclusive = true;
+};
+
+//! Resume each of a list of waiters on this thread
+//!
+//! A resumed waiter usually releases the lock it was handed, which resumes the next waiter in turn.
+//! Rather than resuming it from inside the previous one, and nesting a stack frame per waiter in a
+//! long queue, waiters handed a lock while this thread is already resuming are queued, and resumed
+//! by the outermost call once the current one suspends or finishes.
+inline void resume_all(AsyncWaiter* waiters) noexcept
+{
+    struct ResumeQueue
+    {
+        AsyncWaiter* m_head = nullptr;
+        AsyncWaiter* m_tail = nullptr;
+        bool m_draining = false;
+    };
+    thread_local ResumeQueue queue;
+
+    if (waiters == nullptr)
+    {
+        return;
+    }
+    AsyncWaiter* last = waiters;
+    while (last->m_next != nullptr)
+    {
+        last = last->m_next;
+    }
+    if (queue.m_tail == nullptr)
+    {
+        queue.m_head = waiters;
+    } else
+    {
+        queue.m_tail->m_next = waiters;
+    }
+    queue.m_tail = last;
+    if (queue.m_draining)
+    {
+        return;
+    }
+
+    queue.m_draining = true;
+    while (queue.m_head != nullptr)
+    {
+        // Resuming the coroutine may destroy the waiter
+        AsyncWaiter* waiter = queue.m_head;
+        queue.m_head = waiter->m_next;
+        if (queue.m_head == nullptr)
+        {
+            queue.m_tail = nullptr;
+        }
+        waiter->m_handle.resume();
+    }
+    queue.m_draining = false;
+}
+
+//! The lock behind an AsyncMutex
+//!
+//! The state word is either unlocked, locked, or a pointer to the most recently pushed waiter in a
+//! lock-free stack of waiters. The owner moves the stack into a private FIFO queue when unlocking,
+//! and hands the lock directly to the first waiter in it.
+class AsyncMutexCore
+{
+  public:
+    AsyncMutexCore() noexcept = default;
+    AsyncMutexCore(const AsyncMutexCore&) = delete;
+    AsyncMutexCore& operator=(const AsyncMutexCore&) = delete;
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        std::uintptr_t expected = not_locked;
+        return m_state.compare_exchange_strong(
+            expected, locked_no_waiters, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    //! Either acquire the lock, or push @p waiter to be resumed once the lock is handed to it
+    //!
+    //! @returns true if the waiter was pushed, and its coroutine should suspend
+    [[nodiscard]] bool lock_or_push(AsyncWaiter& waiter) noexcept
+    {
+        std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (state == not_locked)
+            {
+                if (m_state.compare_exchange_weak(state,
+                                                  locked_no_waiters,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed))
+                {
+                    return false;
+                }
+            } else
+            {
+                waiter.m_next = reinterpret_cast<AsyncWaiter*>(state);
+                if (m_state.compare_exchange_weak(state,
+                                                  reinterpret_cast<std::uintptr_t>(&waiter),
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    //! Release the lock, or hand it to the next waiter and resume it
+    void unlock() noexcept
+    {
+        AsyncWaiter* next = m_waiters;
+        if (next == nullptr)
+        {
+            std::uintptr_t expected = locked_no_waiters;
+            if (m_state.compare_exchange_strong(
+                    expected, not_locked, std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            // Take the pushed waiters, leaving the lock held, and reverse them into FIFO order
+            auto* pushed = reinterpret_cast<AsyncWaiter*>(
+                m_state.exchange(locked_no_waiters, std::memory_order_acquire));
+            while (pushed != nullptr)
+            {
+                AsyncWaiter* following = pushed->m_next;
+                pushed->m_next = next;
+                next = pushed;
+                pushed = following;
+            }
+        }
+        m_waiters = next->m_next;
+        next->m_next = nullptr;
+        resume_all(next);
+    }
+
+  private:
+    // A null waiter stack means locked, so that the first waiter's m_next can be the state itself
+    static constexpr std::uintptr_t not_locked = 1;
+    static constexpr std::uintptr_t locked_no_waiters = 0;
+
+    std::atomic<std::uintptr_t> m_state{not_locked};
+    //! Waiters taken from the stack by the owner, in FIFO order
+    AsyncWaiter* m_waiters = nullptr;
+};
+
+//! The lock behind an AsyncRwLock
+//!
+//! Waiters are queued in FIFO order behind a short internal spin lock that's never held while
+//! resuming a coroutine. Once a writer is waiting, new readers queue behind it.
+class AsyncSharedMutexCore
+{
+  public:
+    AsyncSharedMutexCore() noexcept = default;
+    AsyncSharedMutexCore(const AsyncSharedMutexCore&) = delete;
+    AsyncSharedMutexCore& operator=(const AsyncSharedMutexCore&) = delete;
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        std::lock_guard<SpinLock> lock(m_lock);
+        return try_acquire(true);
+    }
+
+    [[nodiscard]] bool try_lock_shared() noexcept
+    {
+        std::lock_guard<SpinLock> lock(m_lock);
+        return try_acquire(false);
+    }
+
+    //! Either acquire the lock, or queue @p waiter to be resumed once the lock is handed to it
+    //!
+    //! @returns true if the waiter was queued, and its coroutine should suspend
+    [[nodiscard]] bool lock_or_push(AsyncWaiter& waiter) noexcept
+    {
+        std::lock_guard<SpinLock> lock(m_lock);
+        if (try_acquire(waiter.m_exclusive))
+        {
+            return false;
+        }
+        waiter.m_next = nullptr;
+        if (m_tail == nullptr)
+        {
+            m_head = &waiter;
+        } else
+        {
+            m_tail->m_next = &waiter;
+        }
+        m_tail = &waiter;
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        AsyncWaiter* admitted = nullptr;
+        {
+            std::lock_guard<SpinLock> lock(m_lock);
+            m_writer = false;
+            admitted = admit();
+        }
+        resume_all(admitted);
+    }
+
+    void unlock_shared() noexcept
+    {
+        AsyncWaiter* admitted = nullptr;
+        {
+            std::lock_guard<SpinLock> lock(m_lock);
+            if (--m_readers == 0)
+            {
+                admitted = admit();
+            }
+        }
+        resume_all(admitted);
+    }
+
+  private:
+    bool try_acquire(bool exclusive) noexcept
+    {
+        if (m_writer || m_head != nullptr)
+        {
+            return false;
+        }
+        if (exclusive)
+        {
+            if (m_readers != 0)
+            {
+                return false;
+            }
+            m_writer = true;
+        } else
+        {
+            m_readers++;
+        }
+        return true;
+    }
+
+    //! Dequeue either the next writer, or every reader at the front of the queue, and hand them
+    //! the lock
+    //!
+    //! @note The lock must be free, and m_lock held.
+    AsyncWaiter* admit() noexcept
+    {
+        AsyncWaiter* admitted = m_head;
+        if (admitted == nullptr)
+        {
+            return nullptr;
+        }
+
+        AsyncWaiter* last = admitted;
+        if (admitted->m_exclusive)
+        {
+            m_writer = true;
+        } else
+        {
+            m_readers++;
+            while (last->m_next != nullptr && !last->m_next->m_exclusive)
+            {
+                last = last->m_next;
+                m_readers++;
+            }
+        }
+
+        m_head = last->m_next;
+        if (m_head == nullptr)
+        {
+            m_tail = nullptr;
+        }
+        last->m_next = nullptr;
+        return admitted;
+    }
+
+    SpinLock m_lock;
+    std::size_t m_readers = 0;
+    bool m_writer = false;
+    AsyncWaiter* m_head = nullptr;
+    AsyncWaiter* m_tail = nullptr;
+};
+
+//! The awaitable returned by locking an async lock
+//!
+//! Awaiting it suspends the coroutine until @p CoreT hands it the lock, and then produces a guard
+//! from @p OwnerT.
+template<typename OwnerT, typename CoreT, bool v_Exclusive>
+class AsyncLockAwaiter : private AsyncWaiter
+{
+  public:
+    AsyncLockAwaiter(OwnerT& owner, CoreT& core, bool checked) noexcept :
+        m_owner(owner), m_core(core), m_checked(checked)
+    {
+        m_exclusive = v_Exclusive;
+    }
+
+    AsyncLockAwaiter(const AsyncLockAwaiter&) = delete;
+    AsyncLockAwaiter& operator=(const AsyncLockAwaiter&) = delete;
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        if constexpr (v_Exclusive)
+        {
+            return m_core.try_lock();
+        } else
+        {
+            return m_core.try_lock_shared();
+        }
+    }
+
+    [[nodiscard]] bool await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+        m_handle = handle;
+        return m_core.lock_or_push(*this);
+    }
+
+    [[nodiscard]] auto await_resume() noexcept(false) { return m_owner.adopt_guard(m_checked); }
+
+  private:
+    OwnerT& m_owner;
+    CoreT& m_core;
+    bool m_checked;
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A Rust-inspired mutex for coroutines, that suspends instead of blocking
+//!
+//! `co_await mutex.lock()` produces the same MutexGuard, with the same poisoning semantics, as
+//! Mutex::lock(). When the guard is released, the lock is handed to the next waiting coroutine,
+//! which is resumed on the releasing thread before the guard's destructor returns. A guard released
+//! by a coroutine that was itself resumed that way hands the lock over immediately, but the next
+//! waiter only runs once the releasing coroutine suspends or finishes.
+template<typename ValueT>
+class AsyncMutex
+{
+    using Core = detail::AsyncMutexCore;
+    using LockAwaiter = detail::AsyncLockAwaiter<AsyncMutex, Core, true>;
+
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit AsyncMutex(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit AsyncMutex(ArgsT&&... args) : m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    //! Lock the mutex, and produce an RAII guard controlling access to the underlying value
+    //!
+    //! Awaiting the lock throws std::runtime_error if the AsyncMutex has been poisoned.
+    [[nodiscard]] LockAwaiter lock() noexcept { return LockAwaiter(*this, m_core, true); }
+
+    //! Lock the mutex, and produce an RAII guard, without checking for poison
+    [[nodiscard]] LockAwaiter lock_unchecked() noexcept
+    {
+        return LockAwaiter(*this, m_core, false);
+    }
+
+    //! Attempt to lock the mutex without suspending
+    //!
+    //! @throws std::runtime_error if the AsyncMutex has been poisoned.
+    [[nodiscard]] std::optional<MutexGuard<ValueT, Core>> try_lock() noexcept(false)
+    {
+        if (!m_core.try_lock())
+        {
+            return std::nullopt;
+        }
+        return std::optional<MutexGuard<ValueT, Core>>(std::in_place, adopt_guard(true));
+    }
+
+    //! Indicates whether this AsyncMutex has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_was_poisoned; }
+
+    //! Clear the poisoned state of this AsyncMutex
+    void clear_poison() noexcept { m_was_poisoned = false; }
+
+  private:
+    friend LockAwaiter;
+
+    //! Wrap the lock handed to an awaiter in a guard
+    MutexGuard<ValueT, Core> adopt_guard(bool checked) noexcept(false)
+    {
+        std::unique_lock<Core> lock(m_core, std::adopt_lock);
+        if (checked)
+        {
+            throw_if_poisoned();
+        }
+        return MutexGuard(m_value, std::move(lock), m_was_poisoned);
+    }
+
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+        }
+    }
+
+    Core m_core;
+    ValueT m_value;
+    bool m_was_poisoned = false;
+};
+
+//! A reader/writer lock for coroutines, that suspends instead of blocking
+//!
+//! Like a Mutex with a SharedLockable lock, locking a `const AsyncRwLock` produces a read-only
+//! MutexReadGuard shared with other readers, and locking a non-const one produces an exclusive
+//! MutexGuard. Only exclusive guards can poison the lock.
+template<typename ValueT>
+class AsyncRwLock
+{
+    using Core = detail::AsyncSharedMutexCore;
+    using LockAwaiter = detail::AsyncLockAwaiter<AsyncRwLock, Core, true>;
+    using ReadLockAwaiter = detail::AsyncLockAwaiter<const AsyncRwLock, Core, false>;
+
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit AsyncRwLock(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit AsyncRwLock(ArgsT&&... args) : m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    //! Lock exclusively, and produce an RAII guard controlling access to the underlying value
+    //!
+    //! Awaiting the lock throws std::runtime_error if the AsyncRwLock has been poisoned.
+    [[nodiscard]] LockAwaiter lock() noexcept { return LockAwaiter(*this, m_core, true); }
+
+    //! Lock exclusively, and produce an RAII guard, without checking for poison
+    [[nodiscard]] LockAwaiter lock_unchecked() noexcept
+    {
+        return LockAwaiter(*this, m_core, false);
+    }
+
+    //! Lock for reading, and produce an RAII guard providing read-only access to the underlying
+    //! value
+    //!
+    //! Awaiting the lock throws std::runtime_error if the AsyncRwLock has been poisoned.
+    [[nodiscard]] ReadLockAwaiter lock() const noexcept
+    {
+        return ReadLockAwaiter(*this, m_core, true);
+    }
+
+    //! Lock for reading, and produce an RAII guard, without checking for poison
+    [[nodiscard]] ReadLockAwaiter lock_unchecked() const noexcept
+    {
+        return ReadLockAwaiter(*this, m_core, false);
+    }
+
+    //! Attempt to lock exclusively without suspending
+    //!
+    //! @throws std::runtime_error if the AsyncRwLock has been poisoned.
+    [[nodiscard]] std::optional<MutexGuard<ValueT, Core>> try_lock() noexcept(false)
+    {
+        if (!m_core.try_lock())
+        {
+            return std::nullopt;
+        }
+        return std::optional<MutexGuard<ValueT, Core>>(std::in_place, adopt_guard(true));
+    }
+
+    //! Attempt to lock for reading without suspending
+    //!
+    //! @throws std::runtime_error if the AsyncRwLock has been poisoned.
+    [[nodiscard]] std::optional<MutexReadGuard<ValueT, Core>> try_lock() const noexcept(false)
+    {
+        if (!m_core.try_lock_shared())
+        {
+            return std::nullopt;
+        }
+        return std::optional<MutexReadGuard<ValueT, Core>>(std::in_place, adopt_guard(true));
+    }
+
+    //! Indicates whether this AsyncRwLock has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_was_poisoned; }
+
+    //! Clear the poisoned state of this AsyncRwLock
+    void clear_poison() noexcept { m_was_poisoned = false; }
+
+  private:
+    friend LockAwaiter;
+    friend ReadLockAwaiter;
+
+    //! Wrap the exclusive lock handed to an awaiter in a guard
+    MutexGuard<ValueT, Core> adopt_guard(bool checked) noexcept(false)
+    {
+        std::unique_lock<Core> lock(m_core, std::adopt_lock);
+        if (checked)
+        {
+            throw_if_poisoned();
+        }
+        return MutexGuard(m_value, std::move(lock), m_was_poisoned);
+    }
+
+    //! Wrap the shared lock handed to an awaiter in a guard
+    MutexReadGuard<ValueT, Core> adopt_guard(bool checked) const noexcept(false)
+    {
+        std::shared_lock<Core> lock(m_core, std::adopt_lock);
+        if (checked)
+        {
+            throw_if_poisoned();
+        }
+        return MutexReadGuard(m_value, std::move(lock));
+    }
+
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+        }
+    }
+
+    mutable Core m_core;
+    ValueT m_value;
+    bool m_was_poisoned = false;
+};
+
+}  // namespace rmx
@@ -0,0 +1,451 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+#include <rmx/rmx.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! Broadcast tag type for a ring with a single publishing thread
+struct SingleProducer
+{
+};
+
+//! Broadcast tag type for a ring that any number of threads publish to
+struct MultiProducer
+{
+};
+
+//! A Broadcast wait strategy that spins, for the lowest latency on dedicated cores
+struct BusySpinWait
+{
+    template<typename ConditionT>
+    void wait_until(ConditionT&& condition) noexcept
+    {
+        while (!condition())
+        {
+            detail::cpu_relax();
+        }
+    }
+
+    void notify_all() noexcept {}
+};
+
+//! A Broadcast wait strategy that spins briefly, and then yields to other threads
+struct YieldingWait
+{
+    template<typename ConditionT>
+    void wait_until(ConditionT&& condition) noexcept
+    {
+        for (unsigned spins = 0; !condition(); spins++)
+        {
+            if (spins < max_spins)
+            {
+                detail::cpu_relax();
+            } else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void notify_all() noexcept {}
+
+  private:
+    static constexpr unsigned max_spins = 100;
+};
+
+//! A Broadcast wait strategy that spins briefly, and then sleeps on a futex
+//!
+//! Notifying makes a syscall only if a thread is asleep.
+class BlockingWait
+{
+  public:
+    template<typename ConditionT>
+    void wait_until(ConditionT&& condition) noexcept
+    {
+        for (unsigned spins = 0; !condition(); spins++)
+        {
+            if (spins < max_spins)
+            {
+                detail::cpu_relax();
+                continue;
+            }
+
+            const std::uint32_t epoch = m_event.prepare_wait();
+            if (condition())
+            {
+                m_event.cancel_wait();
+                return;
+            }
+            m_event.wait(epoch);
+        }
+    }
+
+    void notify_all() noexcept { m_event.notify_all(); }
+
+  private:
+    static constexpr unsigned max_spins = 64;
+
+    detail::EventCount m_event;
+};
+
+template<typename ValueT, typename ProducerT, typename WaitT, std::size_t v_MaxSubscribers>
+class Broadcast;
+
+//! One subscriber's view of a Broadcast, which reads every event published after it subscribed
+//!
+//! Events are read in place, by sequence number, without any locks. The producer can't overwrite
+//! an event until every subscriber has read it. Unsubscribes when it goes out of scope.
+//!
+//! Acquire a `BroadcastReceiver` by calling `Broadcast::subscribe()`.
+template<typename ValueT, typename ProducerT, typename WaitT, std::size_t v_MaxSubscribers>
+class BroadcastReceiver
+{
+    using BroadcastT = Broadcast<ValueT, ProducerT, WaitT, v_MaxSubscribers>;
+
+  public:
+    explicit BroadcastReceiver(BroadcastT& broadcast,
+                               std::size_t subscriber,
+                               std::uint64_t sequence) noexcept :
+        m_broadcast(&broadcast), m_subscriber(subscriber), m_next(sequence)
+    {
+    }
+
+    BroadcastReceiver(BroadcastReceiver&& other) noexcept :
+        m_broadcast(std::exchange(other.m_broadcast, nullptr)),
+        m_subscriber(other.m_subscriber),
+        m_next(other.m_next)
+    {
+    }
+
+    BroadcastReceiver& operator=(BroadcastReceiver&&) = delete;
+    BroadcastReceiver(const BroadcastReceiver&) = delete;
+    BroadcastReceiver& operator=(const BroadcastReceiver&) = delete;
+
+    ~BroadcastReceiver()
+    {
+        if (m_broadcast != nullptr)
+        {
+            m_broadcast->unsubscribe(m_subscriber);
+        }
+    }
+
+    //! Wait for at least one event, and pass up to @p max consecutive events to @p handler
+    //!
+    //! @p handler is invoked as `handler(const ValueT& event, std::uint64_t sequence)`. If it
+    //! throws, the events before the one that threw have been read, and the rest haven't.
+    //!
+    //! @returns how many events were read, which is zero once the Broadcast has been closed and
+    //! every event read
+    template<typename FunctionT>
+    std::size_t read_batch(FunctionT&& handler,
+                           std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+        m_broadcast->m_readable.wait_until(
+            [this] { return m_broadcast->is_published(m_next) || m_broadcast->is_closed(); });
+        return try_read_batch(std::forward<FunctionT>(handler), max);
+    }
+
+    //! Pass up to @p max consecutive events that have already been published to @p handler
+    //!
+    //! @returns how many events were read
+    template<typename FunctionT>
+    std::size_t try_read_batch(FunctionT&& handler,
+                               std::size_t max = std::numeric_limits<std::size_t>::max())
+    {
+        std::size_t count = 0;
+        try
+        {
+            while (count < max && m_broadcast->is_published(m_next))
+            {
+                std::invoke(handler, std::as_const(m_broadcast->slot(m_next).m_value), m_next);
+                m_next++;
+                count++;
+            }
+        } catch (...)
+        {
+            m_broadcast->advance(m_subscriber, m_next);
+            throw;
+        }
+        if (count != 0)
+        {
+            m_broadcast->advance(m_subscriber, m_next);
+        }
+        return count;
+    }
+
+    //! Wait for the next event, and return a copy of it
+    //!
+    //! @returns the event, or an empty optional once the Broadcast has been closed and every event
+    //! read
+    [[nodiscard]] std::optional<ValueT> recv()
+    {
+        std::optional<ValueT> value;
+        read_batch([&value](const ValueT& event, std::uint64_t) { value.emplace(event); }, 1);
+        return value;
+    }
+
+    //! Return a copy of the next event, if it's been published
+    [[nodiscard]] std::optional<ValueT> try_recv()
+    {
+        std::optional<ValueT> value;
+        try_read_batch([&value](const ValueT& event, std::uint64_t) { value.emplace(event); }, 1);
+        return value;
+    }
+
+    //! The sequence number of the next event this subscriber will read
+    [[nodiscard]] std::uint64_t sequence() const noexcept { return m_next; }
+
+  private:
+    BroadcastT* m_broadcast;
+    std::size_t m_subscriber;
+    std::uint64_t m_next;
+};
+
+//! A preallocated ring buffer that fans every event out to every subscriber, like the LMAX
+//! Disruptor
+//!
+//! Producers write events in place and publish them by sequence number. Subscribers read them in
+//! place, each at its own pace, and the producers wait for the slowest subscriber before reusing a
+//! slot. Nothing locks, and nothing is allocated after construction.
+//!
+//! @p ProducerT is SingleProducer or MultiProducer. @p WaitT is BusySpinWait, YieldingWait, or
+//! BlockingWait, and is used both by subscribers waiting for events and by producers waiting for
+//! the slowest subscriber.
+//!
+//! @code
+//! rmx::Broadcast<Quote> quotes(1024);
+//! auto receiver = quotes.subscribe();
+//!
+//! quotes.publish(quote);
+//! receiver.read_batch([](const Quote& quote, std::uint64_t sequence) { update(quote); });
+//! @endcode
+template<typename ValueT,
+         typename ProducerT = SingleProducer,
+         typename WaitT = BlockingWait,
+         std::size_t v_MaxSubscribers = 16>
+class Broadcast
+{
+    static_assert(std::is_default_constructible_v<ValueT>,
+                  "Broadcast preallocates its events, so they must be default constructible");
+    static_assert(std::is_same_v<ProducerT, SingleProducer> ||
+                      std::is_same_v<ProducerT, MultiProducer>,
+                  "ProducerT must be SingleProducer or MultiProducer");
+
+  public:
+    using Receiver = BroadcastReceiver<ValueT, ProducerT, WaitT, v_MaxSubscribers>;
+
+    //! Preallocate @p capacity default constructed events
+    //!
+    //! @throws std::invalid_argument if @p capacity isn't a power of two.
+    explicit Broadcast(std::size_t capacity) noexcept(false) :
+        m_mask(capacity - 1), m_slots(std::make_unique<Slot[]>(capacity))
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::invalid_argument("A Broadcast's capacity must be a power of two");
+        }
+    }
+
+    Broadcast(const Broadcast&) = delete;
+    Broadcast& operator=(const Broadcast&) = delete;
+
+    //! Publish @p value, waiting for the slowest subscriber if the ring is full
+    //!
+    //! @returns the event's sequence number
+    std::uint64_t publish(ValueT value)
+    {
+        return publish_with([&value](ValueT& event) { event = std::move(value); });
+    }
+
+    //! Claim the next event, overwrite it in place with @p function, and publish it
+    //!
+    //! @p function is invoked with a reference to the event that was published a lap ago. Later
+    //! sequences can't be read until this one is published, so if @p function throws, the event
+    //! is published anyway, in whatever state @p function left it.
+    //!
+    //! @returns the event's sequence number
+    template<typename FunctionT>
+    std::uint64_t publish_with(FunctionT&& function)
+    {
+        const std::uint64_t sequence = claim();
+        wait_for_space(sequence);
+
+        Slot& slot = this->slot(sequence);
+        try
+        {
+            std::invoke(std::forward<FunctionT>(function), slot.m_value);
+        } catch (...)
+        {
+            commit(slot, sequence);
+            throw;
+        }
+        commit(slot, sequence);
+        return sequence;
+    }
+
+    //! Subscribe to every event published from now on
+    //!
+    //! @throws std::runtime_error if there are already @p v_MaxSubscribers subscribers.
+    [[nodiscard]] Receiver subscribe() noexcept(false)
+    {
+        for (std::size_t i = 0; i < v_MaxSubscribers; i++)
+        {
+            std::atomic<std::uint64_t>& cursor = m_cursors[i].m_next;
+            std::uint64_t expected = unsubscribed;
+            std::uint64_t start = m_claimed.load(std::memory_order_seq_cst);
+            if (!cursor.compare_exchange_strong(expected, start, std::memory_order_seq_cst))
+            {
+                continue;
+            }
+
+            // A producer that claimed a sequence before this cursor was visible might not have
+            // waited for it, so start after any such sequence
+            for (std::uint64_t latest = m_claimed.load(std::memory_order_seq_cst); latest != start;
+                 latest = m_claimed.load(std::memory_order_seq_cst))
+            {
+                start = latest;
+                cursor.store(start, std::memory_order_seq_cst);
+            }
+            return Receiver(*this, i, start);
+        }
+        throw std::runtime_error("Every Broadcast subscriber slot is in use");
+    }
+
+    //! Close the Broadcast, and wake every waiting subscriber
+    //!
+    //! Subscribers read the events that have already been published, and then stop. Close only
+    //! after the last event has been published.
+    void close() noexcept
+    {
+        m_closed.store(true, std::memory_order_seq_cst);
+        m_readable.notify_all();
+    }
+
+    //! Indicates whether this Broadcast has been closed
+    [[nodiscard]] bool is_closed() const noexcept
+    {
+        return m_closed.load(std::memory_order_seq_cst);
+    }
+
+    //! How many events the ring holds
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_mask + 1; }
+
+  private:
+    friend Receiver;
+
+    static constexpr std::uint64_t unsubscribed = std::numeric_limits<std::uint64_t>::max();
+
+    struct Slot
+    {
+        //! One past the sequence number of the event in this slot, once it's been published
+        std::atomic<std::uint64_t> m_published{0};
+        ValueT m_value{};
+    };
+
+    struct alignas(hardware_destructive_interference_size) Cursor
+    {
+        std::atomic<std::uint64_t> m_next{unsubscribed};
+    };
+
+    Slot& slot(std::uint64_t sequence) noexcept { return m_slots[sequence & m_mask]; }
+
+    [[nodiscard]] bool is_published(std::uint64_t sequence) noexcept
+    {
+        return slot(sequence).m_published.load(std::memory_order_acquire) == sequence + 1;
+    }
+
+    std::uint64_t claim() noexcept
+    {
+        if constexpr (std::is_same_v<ProducerT, SingleProducer>)
+        {
+            const std::uint64_t sequence = m_claimed.load(std::memory_order_relaxed);
+            m_claimed.store(sequence + 1, std::memory_order_seq_cst);
+            return sequence;
+        } else
+        {
+            return m_claimed.fetch_add(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void commit(Slot& slot, std::uint64_t sequence) noexcept
+    {
+        slot.m_published.store(sequence + 1, std::memory_order_release);
+        m_readable.notify_all();
+    }
+
+    //! The lowest sequence any subscriber has yet to read, or @p sequence if there are none
+    [[nodiscard]] std::uint64_t slowest_subscriber(std::uint64_t sequence) const noexcept
+    {
+        std::uint64_t slowest = sequence;
+        for (const Cursor& cursor : m_cursors)
+        {
+            const std::uint64_t next = cursor.m_next.load(std::memory_order_seq_cst);
+            if (next != unsubscribed && next < slowest)
+            {
+                slowest = next;
+            }
+        }
+        return slowest;
+    }
+
+    //! Wait until every subscriber has read the event a lap before @p sequence
+    //!
+    //! With several producers, also wait until the event a lap before has been published, so that
+    //! a producer never writes a slot another producer is still writing, even with no subscribers
+    //! to hold it back, and each slot is published in sequence order.
+    void wait_for_space(std::uint64_t sequence) noexcept
+    {
+        if constexpr (std::is_same_v<ProducerT, MultiProducer>)
+        {
+            if (sequence >= capacity())
+            {
+                const std::uint64_t previous = sequence - capacity();
+                m_readable.wait_until([this, previous] { return is_published(previous); });
+            }
+        }
+
+        // Subscribers only move forward, so a stale gate is still safe to pass
+        if (sequence < m_gate.load(std::memory_order_acquire) + capacity())
+        {
+            return;
+        }
+        m_writable.wait_until([this, sequence] {
+            const std::uint64_t gate = slowest_subscriber(sequence);
+            m_gate.store(gate, std::memory_order_release);
+            return sequence < gate + capacity();
+        });
+    }
+
+    void advance(std::size_t subscriber, std::uint64_t next) noexcept
+    {
+        m_cursors[subscriber].m_next.store(next, std::memory_order_release);
+        m_writable.notify_all();
+    }
+
+    void unsubscribe(std::size_t subscriber) noexcept { advance(subscriber, unsubscribed); }
+
+    alignas(hardware_destructive_interference_size) std::atomic<std::uint64_t> m_claimed{0};
+    //! A lower bound on the slowest subscriber, cached so producers rarely scan the cursors
+    std::atomic<std::uint64_t> m_gate{0};
+    WaitT m_writable;
+    alignas(hardware_destructive_interference_size) WaitT m_readable;
+    std::atomic<bool> m_closed{false};
+    alignas(hardware_destructive_interference_size) const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    std::array<Cursor, v_MaxSubscribers> m_cursors;
+};
+
+}  // namespace rmx
@@ -0,0 +1,679 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+#include <rmx/detail/spin_lock.hpp>
+#include <rmx/rmx.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! The outcome of attempting to send or receive on a channel
+enum class ChannelStatus
+{
+    Ready,
+    //! The channel is full, when sending, or empty, when receiving
+    Blocked,
+    Closed,
+};
+
+//! A bounded, lock-free multi-producer multi-consumer queue in a ring buffer
+//!
+//! Each slot has a sequence number that tells a sender whether the slot is free in the sender's lap
+//! around the ring, and tells a receiver whether it's been written, as in Dmitry Vyukov's bounded
+//! MPMC queue. Sequences count in half steps, so that a written slot is never mistaken for a free
+//! one even when the capacity is one. The highest bit of the tail marks the queue closed, so that
+//! closing it and sending to it can't race.
+template<typename ValueT>
+class ArrayQueue
+{
+  public:
+    static constexpr bool is_bounded = true;
+
+    explicit ArrayQueue(std::size_t capacity) noexcept(false) :
+        m_capacity(capacity), m_slots(std::make_unique<Slot[]>(capacity))
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("A bounded channel needs a capacity of at least one");
+        }
+        for (std::size_t i = 0; i < capacity; i++)
+        {
+            m_slots[i].m_sequence.store(free_stamp(i), std::memory_order_relaxed);
+        }
+    }
+
+    ArrayQueue(const ArrayQueue&) = delete;
+    ArrayQueue& operator=(const ArrayQueue&) = delete;
+
+    ~ArrayQueue()
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed) & ~closed_bit;
+        for (std::size_t position = m_head.load(std::memory_order_relaxed); position != tail;
+             position++)
+        {
+            slot(position).m_value.~ValueT();
+        }
+    }
+
+    [[nodiscard]] ChannelStatus try_push(ValueT& value) noexcept
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        for (unsigned spins = 0;; spins++)
+        {
+            if ((tail & closed_bit) != 0)
+            {
+                return ChannelStatus::Closed;
+            }
+            Slot& slot = this->slot(tail);
+            const std::size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+            if (sequence == free_stamp(tail))
+            {
+                if (m_tail.compare_exchange_weak(
+                        tail, tail + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    ::new (static_cast<void*>(&slot.m_value)) ValueT(std::move(value));
+                    slot.m_sequence.store(written_stamp(tail), std::memory_order_release);
+                    return ChannelStatus::Ready;
+                }
+                continue;
+            }
+            if (static_cast<std::ptrdiff_t>(sequence - free_stamp(tail)) < 0)
+            {
+                // The slot still holds a value from the previous lap, unless a receiver is midway
+                // through taking it
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_head.load(std::memory_order_relaxed) + m_capacity == tail)
+                {
+                    return ChannelStatus::Blocked;
+                }
+                SpinLock::backoff(spins);
+            }
+            tail = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] ChannelStatus try_pop(std::optional<ValueT>& out) noexcept
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        for (unsigned spins = 0;; spins++)
+        {
+            Slot& slot = this->slot(head);
+            const std::size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+            if (sequence == written_stamp(head))
+            {
+                if (m_head.compare_exchange_weak(
+                        head, head + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    out.emplace(std::move(slot.m_value));
+                    slot.m_value.~ValueT();
+                    slot.m_sequence.store(free_stamp(head + m_capacity), std::memory_order_release);
+                    return ChannelStatus::Ready;
+                }
+                continue;
+            }
+            if (sequence == free_stamp(head))
+            {
+                // The slot hasn't been written in this lap, unless a sender is midway through
+                // writing it
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+                if ((tail & ~closed_bit) == head)
+                {
+                    return (tail & closed_bit) != 0 ? ChannelStatus::Closed
+                                                    : ChannelStatus::Blocked;
+                }
+                SpinLock::backoff(spins);
+            }
+            head = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    //! @returns false if the queue was already closed
+    bool close() noexcept
+    {
+        return (m_tail.fetch_or(closed_bit, std::memory_order_seq_cst) & closed_bit) == 0;
+    }
+
+    [[nodiscard]] bool is_closed() const noexcept
+    {
+        return (m_tail.load(std::memory_order_seq_cst) & closed_bit) != 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+  private:
+    static constexpr std::size_t closed_bit = std::size_t{1}
+                                              << (std::numeric_limits<std::size_t>::digits - 1);
+
+    struct Slot
+    {
+        Slot() noexcept {}
+        ~Slot() {}
+
+        std::atomic<std::size_t> m_sequence{0};
+        union
+        {
+            ValueT m_value;
+        };
+    };
+
+    static constexpr std::size_t free_stamp(std::size_t position) noexcept { return position * 2; }
+    static constexpr std::size_t written_stamp(std::size_t position) noexcept
+    {
+        return position * 2 + 1;
+    }
+
+    Slot& slot(std::size_t position) noexcept { return m_slots[position % m_capacity]; }
+
+    alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_head{0};
+    alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_tail{0};
+    alignas(hardware_destructive_interference_size) const std::size_t m_capacity;
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+//! An unbounded, lock-free multi-producer multi-consumer queue in a linked list of blocks
+//!
+//! A port of crossbeam's list channel. Indices advance by two, leaving the lowest bit free to mark
+//! the tail closed, and the head as having a following block. The last index of each lap is never
+//! used for a value; reaching it means the next block is being installed. Whichever receiver is
+//! last to finish with a block frees it.
+template<typename ValueT>
+class ListQueue
+{
+  public:
+    static constexpr bool is_bounded = false;
+
+    ListQueue() noexcept = default;
+
+    ListQueue(const ListQueue&) = delete;
+    ListQueue& operator=(const ListQueue&) = delete;
+
+    ~ListQueue()
+    {
+        std::size_t head = m_head.m_index.load(std::memory_order_relaxed) & ~mark_bit;
+        const std::size_t tail = m_tail.m_index.load(std::memory_order_relaxed) & ~mark_bit;
+        Block* block = m_head.m_block.load(std::memory_order_relaxed);
+
+        while (head != tail)
+        {
+            const std::size_t offset = (head >> shift) % lap;
+            if (offset < block_capacity)
+            {
+                block->m_slots[offset].m_value.~ValueT();
+            } else
+            {
+                Block* next = block->m_next.load(std::memory_order_relaxed);
+                delete block;
+                block = next;
+            }
+            head += std::size_t{1} << shift;
+        }
+        delete block;
+    }
+
+    //! @throws std::bad_alloc if a new block can't be allocated
+    [[nodiscard]] ChannelStatus try_push(ValueT& value) noexcept(false)
+    {
+        std::size_t tail = m_tail.m_index.load(std::memory_order_acquire);
+        Block* block = m_tail.m_block.load(std::memory_order_acquire);
+        std::unique_ptr<Block> next_block;
+
+        for (unsigned spins = 0;; spins++)
+        {
+            if ((tail & mark_bit) != 0)
+            {
+                return ChannelStatus::Closed;
+            }
+
+            const std::size_t offset = (tail >> shift) % lap;
+            if (offset == block_capacity)
+            {
+                // Another sender is installing the next block
+                SpinLock::backoff(spins);
+                tail = m_tail.m_index.load(std::memory_order_acquire);
+                block = m_tail.m_block.load(std::memory_order_acquire);
+                continue;
+            }
+
+            // Allocate the next block before claiming the last slot, to keep the window in which
+            // other senders have to wait for it short
+            if (offset + 1 == block_capacity && !next_block)
+            {
+                next_block = std::make_unique<Block>();
+            }
+
+            if (block == nullptr)
+            {
+                auto first = std::make_unique<Block>();
+                Block* expected = nullptr;
+                if (m_tail.m_block.compare_exchange_strong(expected,
+                                                           first.get(),
+                                                           std::memory_order_release,
+                                                           std::memory_order_relaxed))
+                {
+                    m_head.m_block.store(first.get(), std::memory_order_release);
+                    block = first.release();
+                } else
+                {
+                    next_block = std::move(first);
+                    tail = m_tail.m_index.load(std::memory_order_acquire);
+                    block = m_tail.m_block.load(std::memory_order_acquire);
+                    continue;
+                }
+            }
+
+            const std::size_t new_tail = tail + (std::size_t{1} << shift);
+            if (m_tail.m_index.compare_exchange_weak(
+                    tail, new_tail, std::memory_order_seq_cst, std::memory_order_acquire))
+            {
+                if (offset + 1 == block_capacity)
+                {
+                    Block* next = next_block.release();
+                    m_tail.m_block.store(next, std::memory_order_release);
+                    m_tail.m_index.store(new_tail + (std::size_t{1} << shift),
+                                         std::memory_order_release);
+                    block->m_next.store(next, std::memory_order_release);
+                }
+
+                Slot& slot = block->m_slots[offset];
+                ::new (static_cast<void*>(&slot.m_value)) ValueT(std::move(value));
+                slot.m_state.fetch_or(slot_written, std::memory_order_release);
+                return ChannelStatus::Ready;
+            }
+            block = m_tail.m_block.load(std::memory_order_acquire);
+        }
+    }
+
+    [[nodiscard]] ChannelStatus try_pop(std::optional<ValueT>& out) noexcept
+    {
+        std::size_t head = m_head.m_index.load(std::memory_order_acquire);
+        Block* block = m_head.m_block.load(std::memory_order_acquire);
+
+        for (unsigned spins = 0;; spins++)
+        {
+            const std::size_t offset = (head >> shift) % lap;
+            if (offset == block_capacity)
+            {
+                // Another receiver is moving the head to the next block
+                SpinLock::backoff(spins);
+                head = m_head.m_index.load(std::memory_order_acquire);
+                block = m_head.m_block.load(std::memory_order_acquire);
+                continue;
+            }
+
+            std::size_t new_head = head + (std::size_t{1} << shift);
+            if ((new_head & mark_bit) == 0)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const std::size_t tail = m_tail.m_index.load(std::memory_order_relaxed);
+                if ((head >> shift) == (tail >> shift))
+                {
+                    return (tail & mark_bit) != 0 ? ChannelStatus::Closed : ChannelStatus::Blocked;
+                }
+                // Skip this check for the rest of the block once the tail is known to be past it
+                if ((head >> shift) / lap != (tail >> shift) / lap)
+                {
+                    new_head |= mark_bit;
+                }
+            }
+
+            if (block == nullptr)
+            {
+                // The first value is being sent, and its block installed
+                SpinLock::backoff(spins);
+                head = m_head.m_index.load(std::memory_order_acquire);
+                block = m_head.m_block.load(std::memory_order_acquire);
+                continue;
+            }
+
+            if (m_head.m_index.compare_exchange_weak(
+                    head, new_head, std::memory_order_seq_cst, std::memory_order_acquire))
+            {
+                if (offset + 1 == block_capacity)
+                {
+                    Block* next = block->wait_next();
+                    std::size_t next_index = (new_head & ~mark_bit) + (std::size_t{1} << shift);
+                    if (next->m_next.load(std::memory_order_relaxed) != nullptr)
+                    {
+                        next_index |= mark_bit;
+                    }
+                    m_head.m_block.store(next, std::memory_order_release);
+                    m_head.m_index.store(next_index, std::memory_order_release);
+                }
+
+                Slot& slot = block->m_slots[offset];
+                slot.wait_written();
+                out.emplace(std::move(slot.m_value));
+                slot.m_value.~ValueT();
+
+                if (offset + 1 == block_capacity)
+                {
+                    Block::destroy(block, 0);
+                } else if ((slot.m_state.fetch_or(slot_read, std::memory_order_acq_rel) &
+                            slot_destroy) != 0)
+                {
+                    Block::destroy(block, offset + 1);
+                }
+                return ChannelStatus::Ready;
+            }
+            block = m_head.m_block.load(std::memory_order_acquire);
+        }
+    }
+
+    //! @returns false if the queue was already closed
+    bool close() noexcept
+    {
+        return (m_tail.m_index.fetch_or(mark_bit, std::memory_order_seq_cst) & mark_bit) == 0;
+    }
+
+    [[nodiscard]] bool is_closed() const noexcept
+    {
+        return (m_tail.m_index.load(std::memory_order_seq_cst) & mark_bit) != 0;
+    }
+
+  private:
+    static constexpr std::size_t shift = 1;
+    static constexpr std::size_t mark_bit = 1;
+    static constexpr std::size_t lap = 32;
+    static constexpr std::size_t block_capacity = lap - 1;
+
+    static constexpr std::uint32_t slot_written = 1;
+    static constexpr std::uint32_t slot_read = 2;
+    static constexpr std::uint32_t slot_destroy = 4;
+
+    struct Slot
+    {
+        Slot() noexcept {}
+        ~Slot() {}
+
+        void wait_written() const noexcept
+        {
+            for (unsigned spins = 0; (m_state.load(std::memory_order_acquire) & slot_written) == 0;
+                 spins++)
+            {
+                SpinLock::backoff(spins);
+            }
+        }
+
+        union
+        {
+            ValueT m_value;
+        };
+        std::atomic<std::uint32_t> m_state{0};
+    };
+
+    struct Block
+    {
+        Block* wait_next() const noexcept
+        {
+            for (unsigned spins = 0;; spins++)
+            {
+                Block* next = m_next.load(std::memory_order_acquire);
+                if (next != nullptr)
+                {
+                    return next;
+                }
+                SpinLock::backoff(spins);
+            }
+        }
+
+        //! Free @p block once every receiver from slot @p start onward is done with it
+        //!
+        //! A receiver that's still reading a slot is marked to continue destroying the block
+        //! itself.
+        static void destroy(Block* block, std::size_t start) noexcept
+        {
+            // The receiver of the last slot always starts destroying the block, so skip it
+            for (std::size_t i = start; i + 1 < block_capacity; i++)
+            {
+                Slot& slot = block->m_slots[i];
+                if ((slot.m_state.load(std::memory_order_acquire) & slot_read) == 0 &&
+                    (slot.m_state.fetch_or(slot_destroy, std::memory_order_acq_rel) & slot_read) ==
+                        0)
+                {
+                    return;
+                }
+            }
+            delete block;
+        }
+
+        std::atomic<Block*> m_next{nullptr};
+        Slot m_slots[block_capacity];
+    };
+
+    struct Position
+    {
+        std::atomic<std::size_t> m_index{0};
+        std::atomic<Block*> m_block{nullptr};
+    };
+
+    alignas(hardware_destructive_interference_size) Position m_head;
+    alignas(hardware_destructive_interference_size) Position m_tail;
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A multi-producer multi-consumer channel over a lock-free @p QueueT
+//!
+//! Sending and receiving never take a lock. Threads only sleep, on a futex, when a bounded channel
+//! is full or a channel is empty. Once a channel is closed, sending fails, and receiving drains the
+//! values that were already sent.
+//!
+//! Use the Channel and BoundedChannel aliases rather than naming this directly.
+template<typename ValueT, typename QueueT>
+class BasicChannel
+{
+    static_assert(std::is_nothrow_move_constructible_v<ValueT>,
+                  "Channel values must be nothrow move constructible");
+
+  public:
+    //! Construct the channel, passing @p args to the underlying queue
+    template<typename... ArgsT>
+    explicit BasicChannel(ArgsT&&... args) : m_queue(std::forward<ArgsT>(args)...)
+    {
+    }
+
+    BasicChannel(const BasicChannel&) = delete;
+    BasicChannel& operator=(const BasicChannel&) = delete;
+
+    //! Send @p value, waiting for space if the channel is bounded and full
+    //!
+    //! @returns false if the channel has been closed, in which case @p value is dropped
+    bool send(ValueT value) noexcept(false)
+    {
+        const auto status = block_on(m_senders, [&] { return m_queue.try_push(value); });
+        if (status == detail::ChannelStatus::Ready)
+        {
+            m_receivers.notify_one();
+        }
+        return status == detail::ChannelStatus::Ready;
+    }
+
+    //! Send @p value, unless the channel is full or closed
+    //!
+    //! @returns whether @p value was sent. It's only moved from if it was.
+    [[nodiscard]] bool try_send(ValueT& value) noexcept(false)
+    {
+        if (m_queue.try_push(value) == detail::ChannelStatus::Ready)
+        {
+            m_receivers.notify_one();
+            return true;
+        }
+        return false;
+    }
+
+    //! Send each value in [@p first, @p last), waiting for space as needed
+    //!
+    //! Receivers are woken once per run of values sent without waiting, rather than once per value.
+    //!
+    //! @returns how many values were sent, which is fewer than requested if the channel was closed
+    template<typename IteratorT>
+    std::size_t send_many(IteratorT first, IteratorT last) noexcept(false)
+    {
+        std::size_t sent = 0;
+        std::size_t unannounced = 0;
+        for (; first != last; ++first)
+        {
+            ValueT value(*first);
+            auto status = m_queue.try_push(value);
+            if (status == detail::ChannelStatus::Blocked)
+            {
+                announce(m_receivers, unannounced);
+                status = block_on(m_senders, [&] { return m_queue.try_push(value); });
+            }
+            if (status == detail::ChannelStatus::Closed)
+            {
+                break;
+            }
+            sent++;
+            unannounced++;
+        }
+        announce(m_receivers, unannounced);
+        return sent;
+    }
+
+    //! Receive a value, waiting for one to be sent if the channel is empty
+    //!
+    //! @returns the value, or an empty optional once the channel has been closed and drained
+    [[nodiscard]] std::optional<ValueT> recv() noexcept
+    {
+        std::optional<ValueT> value;
+        const auto status = block_on(m_receivers, [&] { return m_queue.try_pop(value); });
+        if (status == detail::ChannelStatus::Ready && QueueT::is_bounded)
+        {
+            m_senders.notify_one();
+        }
+        return value;
+    }
+
+    //! Receive a value, unless the channel is empty
+    [[nodiscard]] std::optional<ValueT> try_recv() noexcept
+    {
+        std::optional<ValueT> value;
+        if (m_queue.try_pop(value) == detail::ChannelStatus::Ready && QueueT::is_bounded)
+        {
+            m_senders.notify_one();
+        }
+        return value;
+    }
+
+    //! Receive up to @p max values into @p out, waiting for the first if the channel is empty
+    //!
+    //! @returns how many values were received, which is zero once the channel has been closed and
+    //! drained
+    template<typename OutputIteratorT>
+    std::size_t recv_many(OutputIteratorT out, std::size_t max) noexcept(false)
+    {
+        if (max == 0)
+        {
+            return 0;
+        }
+
+        std::optional<ValueT> value;
+        if (block_on(m_receivers, [&] { return m_queue.try_pop(value); }) !=
+            detail::ChannelStatus::Ready)
+        {
+            return 0;
+        }
+
+        std::size_t received = 0;
+        do
+        {
+            *out++ = std::move(*value);
+            value.reset();
+            received++;
+        } while (received < max && m_queue.try_pop(value) == detail::ChannelStatus::Ready);
+
+        if constexpr (QueueT::is_bounded)
+        {
+            std::size_t freed = received;
+            announce(m_senders, freed);
+        }
+        return received;
+    }
+
+    //! Close the channel, and wake every waiting sender and receiver
+    void close() noexcept
+    {
+        if (m_queue.close())
+        {
+            m_senders.notify_all();
+            m_receivers.notify_all();
+        }
+    }
+
+    //! Indicates whether this channel has been closed
+    [[nodiscard]] bool is_closed() const noexcept { return m_queue.is_closed(); }
+
+    //! The most values a bounded channel can hold
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_queue.capacity(); }
+
+  private:
+    static constexpr unsigned max_spins = 64;
+
+    //! Retry @p attempt until it doesn't block, sleeping on @p event between attempts
+    template<typename AttemptT>
+    static detail::ChannelStatus block_on(detail::EventCount& event, AttemptT&& attempt)
+    {
+        for (unsigned spins = 0;; spins++)
+        {
+            auto status = attempt();
+            if (status != detail::ChannelStatus::Blocked)
+            {
+                return status;
+            }
+            if (spins < max_spins)
+            {
+                detail::cpu_relax();
+                continue;
+            }
+
+            const std::uint32_t epoch = event.prepare_wait();
+            status = attempt();
+            if (status != detail::ChannelStatus::Blocked)
+            {
+                event.cancel_wait();
+                return status;
+            }
+            event.wait(epoch);
+        }
+    }
+
+    //! Wake enough waiters on @p event to take @p count values or slots, and reset @p count
+    static void announce(detail::EventCount& event, std::size_t& count) noexcept
+    {
+        if (count == 1)
+        {
+            event.notify_one();
+        } else if (count > 1)
+        {
+            event.notify_all();
+        }
+        count = 0;
+    }
+
+    QueueT m_queue;
+    alignas(hardware_destructive_interference_size) detail::EventCount m_senders;
+    alignas(hardware_destructive_interference_size) detail::EventCount m_receivers;
+};
+
+//! An unbounded multi-producer multi-consumer channel, whose senders never wait
+template<typename ValueT>
+using Channel = BasicChannel<ValueT, detail::ListQueue<ValueT>>;
+
+//! A bounded multi-producer multi-consumer channel, whose senders wait while it's full
+//!
+//! Construct it with its capacity.
+template<typename ValueT>
+using BoundedChannel = BasicChannel<ValueT, detail::ArrayQueue<ValueT>>;
+
+}  // namespace rmx
@@ -0,0 +1,304 @@
+#pragma once
+#include <rmx/detail/spin_lock.hpp>
+#include <rmx/rmx.hpp>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! An operation published to a CombiningMutex, for whichever thread holds the lock to run
+template<typename ValueT>
+struct CombiningRequest
+{
+    using Apply = void (*)(CombiningRequest&, ValueT&);
+
+    explicit CombiningRequest(Apply apply, bool checked) noexcept :
+        m_apply(apply), m_checked(checked)
+    {
+    }
+
+    Apply m_apply;
+    bool m_checked;
+    //! Set instead of running the operation, if the CombiningMutex was poisoned
+    bool m_rejected = false;
+    std::exception_ptr m_error;
+    CombiningRequest* m_next = nullptr;
+    std::atomic<bool> m_done{false};
+};
+
+//! A CombiningRequest that invokes a callable of type @p FunctionT, and stores its result
+template<typename ValueT, typename FunctionT>
+struct CombiningCall : CombiningRequest<ValueT>
+{
+    using ResultT = std::invoke_result_t<FunctionT, ValueT&>;
+    // References are stored by pointer, and void as an unused bool
+    using StoredT = std::conditional_t<
+        std::is_void_v<ResultT>,
+        bool,
+        std::conditional_t<std::is_reference_v<ResultT>, std::add_pointer_t<ResultT>, ResultT>>;
+
+    CombiningCall(FunctionT&& function, bool checked) noexcept :
+        CombiningRequest<ValueT>(&CombiningCall::apply, checked), m_function(function)
+    {
+    }
+
+    static void apply(CombiningRequest<ValueT>& request, ValueT& value)
+    {
+        auto& call = static_cast<CombiningCall&>(request);
+        if constexpr (std::is_void_v<ResultT>)
+        {
+            std::invoke(std::forward<FunctionT>(call.m_function), value);
+        } else if constexpr (std::is_reference_v<ResultT>)
+        {
+            call.m_result = &std::invoke(std::forward<FunctionT>(call.m_function), value);
+        } else
+        {
+            call.m_result.emplace(std::invoke(std::forward<FunctionT>(call.m_function), value));
+        }
+    }
+
+    //! Return the result of the call, or rethrow its exception
+    ResultT take() noexcept(false)
+    {
+        if (this->m_rejected)
+        {
+            throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+        }
+        if (this->m_error)
+        {
+            std::rethrow_exception(this->m_error);
+        }
+        if constexpr (std::is_reference_v<ResultT>)
+        {
+            return static_cast<ResultT>(**m_result);
+        } else if constexpr (!std::is_void_v<ResultT>)
+        {
+            return std::move(*m_result);
+        }
+    }
+
+    std::remove_reference_t<FunctionT>& m_function;
+    std::optional<StoredT> m_result;
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A flat combining mutex for short, highly contended critical sections
+//!
+//! Instead of each thread taking the lock in turn, threads publish their operations, and whichever
+//! thread acquires the lock runs every published operation in a batch. The value, and the lock,
+//! stay in the combining thread's cache for the whole batch, rather than bouncing between CPUs
+//! once per operation.
+//!
+//! Operations are only combined through with() and with_unchecked(). Waiting threads spin, so
+//! operations should be short, and must not lock the same CombiningMutex again.
+template<typename ValueT>
+class CombiningMutex
+{
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit CombiningMutex(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit CombiningMutex(ArgsT&&... args) : m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    //! Run @p function on the underlying value, possibly from another thread combining operations
+    //!
+    //! Blocks until @p function has run.
+    //!
+    //! @returns the result of @p function
+    //! @throws std::runtime_error if the CombiningMutex has been poisoned. If @p function throws,
+    //! the exception is rethrown in the calling thread, and poisons the CombiningMutex.
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with(FunctionT&& function) noexcept(false)
+    {
+        detail::CombiningCall<ValueT, FunctionT> call(std::forward<FunctionT>(function), true);
+        publish_and_wait(call);
+        return call.take();
+    }
+
+    //! Run @p function on the underlying value, without checking for poison
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with_unchecked(FunctionT&& function)
+    {
+        detail::CombiningCall<ValueT, FunctionT> call(std::forward<FunctionT>(function), false);
+        publish_and_wait(call);
+        return call.take();
+    }
+
+    //! Run @p function on the underlying value if the lock is free, and then run any other
+    //! published operations before releasing it
+    //!
+    //! @returns the result of @p function, or an empty optional if the lock was already held. If
+    //! @p function returns void, returns whether it was run.
+    //! @throws std::runtime_error if the CombiningMutex has been poisoned.
+    template<typename FunctionT>
+    detail::MaybeResult<std::invoke_result_t<FunctionT, ValueT&>>
+    try_with(FunctionT&& function) noexcept(false)
+    {
+        if (!m_lock.try_lock())
+        {
+            return {};
+        }
+        detail::CombiningCall<ValueT, FunctionT> call(std::forward<FunctionT>(function), true);
+        run(call);
+        combine();
+        m_lock.unlock();
+
+        if constexpr (std::is_void_v<std::invoke_result_t<FunctionT, ValueT&>>)
+        {
+            call.take();
+            return true;
+        } else
+        {
+            return call.take();
+        }
+    }
+
+    //! Lock the mutex and return an RAII guard controlling access to the underlying value
+    //!
+    //! Operations published while the guard is held are run once it's released.
+    //!
+    //! @throws std::runtime_error if the CombiningMutex has been poisoned.
+    [[nodiscard]] MutexGuard<ValueT, detail::SpinLock> lock() noexcept(false)
+    {
+        std::unique_lock<detail::SpinLock> lock(m_lock);
+        throw_if_poisoned();
+        return MutexGuard(m_value, std::move(lock), m_was_poisoned);
+    }
+
+    //! Lock the mutex and return an RAII guard controlling access to the underlying value,
+    //! without checking for poison
+    [[nodiscard]] MutexGuard<ValueT, detail::SpinLock> lock_unchecked() noexcept
+    {
+        return MutexGuard(m_value, std::unique_lock<detail::SpinLock>(m_lock), m_was_poisoned);
+    }
+
+    //! Attempt to lock the mutex and return an RAII guard controlling access to the underlying
+    //! value
+    //!
+    //! @throws std::runtime_error if the CombiningMutex has been poisoned.
+    [[nodiscard]] std::optional<MutexGuard<ValueT, detail::SpinLock>> try_lock() noexcept(false)
+    {
+        std::unique_lock<detail::SpinLock> maybe_lock(m_lock, std::try_to_lock);
+        if (maybe_lock)
+        {
+            throw_if_poisoned();
+            return std::optional<MutexGuard<ValueT, detail::SpinLock>>(
+                std::in_place, m_value, std::move(maybe_lock), m_was_poisoned);
+        }
+        return std::nullopt;
+    }
+
+    //! Indicates whether this CombiningMutex has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_was_poisoned; }
+
+    //! Clear the poisoned state of this CombiningMutex
+    void clear_poison() noexcept { m_was_poisoned = false; }
+
+  private:
+    using Request = detail::CombiningRequest<ValueT>;
+
+    //! The most batches of published operations a single combiner runs before releasing the lock
+    static constexpr int max_batches = 4;
+
+    void publish_and_wait(Request& request) noexcept
+    {
+        request.m_next = m_published.load(std::memory_order_relaxed);
+        while (!m_published.compare_exchange_weak(
+            request.m_next, &request, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+
+        for (unsigned spins = 0; !request.m_done.load(std::memory_order_acquire); spins++)
+        {
+            if (m_lock.try_lock())
+            {
+                combine();
+                m_lock.unlock();
+                // The request may have been published after the last batch was taken
+                spins = 0;
+                continue;
+            }
+            detail::SpinLock::backoff(spins);
+        }
+    }
+
+    //! Run the published operations, in the order they were published
+    //!
+    //! @note The lock must be held.
+    void combine() noexcept
+    {
+        for (int batch = 0; batch < max_batches; batch++)
+        {
+            Request* request = m_published.exchange(nullptr, std::memory_order_acquire);
+            if (request == nullptr)
+            {
+                return;
+            }
+
+            Request* in_order = nullptr;
+            while (request != nullptr)
+            {
+                Request* next = request->m_next;
+                request->m_next = in_order;
+                in_order = request;
+                request = next;
+            }
+
+            while (in_order != nullptr)
+            {
+                // The publishing thread may return as soon as the request is done
+                Request* next = in_order->m_next;
+                run(*in_order);
+                in_order->m_done.store(true, std::memory_order_release);
+                in_order = next;
+            }
+        }
+    }
+
+    void run(Request& request) noexcept
+    {
+        if (request.m_checked && m_was_poisoned)
+        {
+            request.m_rejected = true;
+            return;
+        }
+        try
+        {
+            request.m_apply(request, m_value);
+        } catch (...)
+        {
+            request.m_error = std::current_exception();
+            m_was_poisoned = true;
+        }
+    }
+
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+        }
+    }
+
+    // Every publishing thread writes the list of published operations, so keep it off the cache
+    // line the combiner works with
+    alignas(hardware_destructive_interference_size) std::atomic<Request*> m_published{nullptr};
+    alignas(hardware_destructive_interference_size) detail::SpinLock m_lock;
+    bool m_was_poisoned = false;
+    ValueT m_value;
+};
+
+}  // namespace rmx
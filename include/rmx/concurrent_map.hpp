@@ -0,0 +1,458 @@
+#pragma once
+#include <rmx/rmx.hpp>
+#include <rmx/sharded.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rmx::detail {
+//! A linear probing hash table, without any synchronization of its own
+//!
+//! Callers provide the mixed hash of each key. Erasing shifts the following entries back into the
+//! hole, so there are no tombstones to slow down later lookups.
+//!
+//! Growing is incremental: the old slots are kept alongside the new ones, and each insert or erase
+//! migrates a few of them, so no single operation pays for rehashing the whole table. Until the
+//! migration finishes, lookups check both.
+template<typename KeyT, typename MappedT, typename EqualT>
+class OpenTable
+{
+  public:
+    [[nodiscard]] MappedT* find(std::uint64_t hash, const KeyT& key) noexcept
+    {
+        Slot* slot = find_slot(*this, hash, key);
+        return slot != nullptr ? &slot->entry->second : nullptr;
+    }
+
+    [[nodiscard]] const MappedT* find(std::uint64_t hash, const KeyT& key) const noexcept
+    {
+        const Slot* slot = find_slot(*this, hash, key);
+        return slot != nullptr ? &slot->entry->second : nullptr;
+    }
+
+    //! Insert a value constructed from @p args, unless @p key is already present
+    //!
+    //! @returns the mapped value for @p key, and whether it was inserted
+    template<typename... ArgsT>
+    std::pair<MappedT*, bool> try_emplace(std::uint64_t hash, KeyT key, ArgsT&&... args)
+    {
+        if (MappedT* existing = find(hash, key); existing != nullptr)
+        {
+            return {existing, false};
+        }
+        migrate();
+        if ((m_size + 1) * max_load_denominator > m_table.slots.size() * max_load_numerator)
+        {
+            grow();
+        }
+
+        // New entries always go in the new slots
+        Slot& slot = m_table.slots[m_table.probe_empty(hash)];
+        slot.entry.emplace(std::piecewise_construct,
+                           std::forward_as_tuple(std::move(key)),
+                           std::forward_as_tuple(std::forward<ArgsT>(args)...));
+        slot.hash = hash;
+        m_size++;
+        return {&slot.entry->second, true};
+    }
+
+    bool erase(std::uint64_t hash, const KeyT& key)
+    {
+        migrate();
+        if (!m_table.erase(hash, key) && !m_old.erase(hash, key))
+        {
+            return false;
+        }
+        m_size--;
+        return true;
+    }
+
+    template<typename FunctionT>
+    void for_each(FunctionT&& function) const
+    {
+        for (const Slots* table : {&m_table, &m_old})
+        {
+            for (const Slot& slot : table->slots)
+            {
+                if (slot.entry.has_value())
+                {
+                    function(slot.entry->first, slot.entry->second);
+                }
+            }
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_table = Slots();
+        m_old = Slots();
+        m_size = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return m_table.slots.size(); }
+
+    //! Indicates whether entries are still being migrated from the slots before the last growth
+    [[nodiscard]] bool is_resizing() const noexcept { return !m_old.slots.empty(); }
+
+  private:
+    static constexpr unsigned min_capacity_bits = 3;
+    static constexpr std::size_t min_capacity = std::size_t{1} << min_capacity_bits;
+    static constexpr std::size_t max_load_numerator = 3;
+    static constexpr std::size_t max_load_denominator = 4;
+    //! The minimum number of old slots to migrate per insert or erase, which finishes a migration
+    //! long before the new slots fill up
+    static constexpr std::size_t migrate_step = 16;
+
+    struct Slot
+    {
+        std::uint64_t hash = 0;
+        std::optional<std::pair<KeyT, MappedT>> entry;
+    };
+
+    //! A power of two number of slots, with the top bits of a hash picking its home slot
+    //!
+    //! ShardedMutex picks the shard from the upper half of the hash modulo the shard count, so with
+    //! a power of two shard count the top bits stay evenly spread within a shard.
+    struct Slots
+    {
+        std::vector<Slot> slots;
+        unsigned shift = 64;
+
+        [[nodiscard]] std::size_t mask() const noexcept { return slots.size() - 1; }
+
+        [[nodiscard]] std::size_t home_of(std::uint64_t hash) const noexcept
+        {
+            return static_cast<std::size_t>(hash >> shift);
+        }
+
+        [[nodiscard]] std::optional<std::size_t> find_index(std::uint64_t hash,
+                                                            const KeyT& key) const noexcept
+        {
+            if (slots.empty())
+            {
+                return std::nullopt;
+            }
+            // The load factor is always less than 1, so there's always an empty slot to stop at
+            for (std::size_t index = home_of(hash); slots[index].entry.has_value();
+                 index = (index + 1) & mask())
+            {
+                const Slot& slot = slots[index];
+                if (slot.hash == hash && EqualT{}(slot.entry->first, key))
+                {
+                    return index;
+                }
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] std::size_t probe_empty(std::uint64_t hash) const noexcept
+        {
+            std::size_t index = home_of(hash);
+            while (slots[index].entry.has_value())
+            {
+                index = (index + 1) & mask();
+            }
+            return index;
+        }
+
+        bool erase(std::uint64_t hash, const KeyT& key)
+        {
+            const std::optional<std::size_t> found = find_index(hash, key);
+            if (!found.has_value())
+            {
+                return false;
+            }
+
+            std::size_t hole = *found;
+            slots[hole].entry.reset();
+
+            // Shift back any following entries that would no longer be reachable from their home
+            // slot
+            for (std::size_t next = (hole + 1) & mask(); slots[next].entry.has_value();
+                 next = (next + 1) & mask())
+            {
+                const std::size_t home = home_of(slots[next].hash);
+                if (((next - home) & mask()) >= ((next - hole) & mask()))
+                {
+                    slots[hole] = std::move(slots[next]);
+                    slots[next].entry.reset();
+                    hole = next;
+                }
+            }
+            return true;
+        }
+    };
+
+    Slots m_table;
+    //! The slots before the last growth, whose entries are still being migrated into m_table
+    Slots m_old;
+    //! The next slot of m_old to migrate
+    std::size_t m_cursor = 0;
+    //! The number of slots of m_old migrated so far
+    std::size_t m_migrated = 0;
+    std::size_t m_size = 0;
+
+    //! Find the slot holding @p key in either set of slots, of a const or non-const table
+    template<typename SelfT>
+    [[nodiscard]] static auto find_slot(SelfT& self, std::uint64_t hash, const KeyT& key) noexcept
+        -> decltype(&self.m_table.slots[0])
+    {
+        for (auto* table : {&self.m_table, &self.m_old})
+        {
+            if (const std::optional<std::size_t> index = table->find_index(hash, key))
+            {
+                return &table->slots[*index];
+            }
+        }
+        return nullptr;
+    }
+
+    //! Migrate at least migrate_step old slots, if a migration is in progress
+    //!
+    //! Migration always stops just after an empty slot, so it moves whole clusters of entries, and
+    //! every entry left in m_old is still reachable by probing from its home slot.
+    void migrate()
+    {
+        for (std::size_t step = 0; is_resizing(); step++)
+        {
+            Slot& slot = m_old.slots[m_cursor];
+            const bool empty = !slot.entry.has_value();
+            if (!empty)
+            {
+                m_table.slots[m_table.probe_empty(slot.hash)] = std::move(slot);
+                slot.entry.reset();
+            }
+            m_cursor = (m_cursor + 1) & m_old.mask();
+
+            if (++m_migrated == m_old.slots.size())
+            {
+                m_old = Slots();
+            } else if (empty && step + 1 >= migrate_step)
+            {
+                return;
+            }
+        }
+    }
+
+    void grow()
+    {
+        // Growing again before a migration finished would need a third set of slots
+        while (is_resizing())
+        {
+            migrate();
+        }
+        if (m_table.slots.empty())
+        {
+            m_table.slots.resize(min_capacity);
+            m_table.shift = 64 - min_capacity_bits;
+            return;
+        }
+
+        Slots grown;
+        grown.slots.resize(m_table.slots.size() * 2);
+        grown.shift = m_table.shift - 1;
+        m_old = std::exchange(m_table, std::move(grown));
+
+        // Start migrating just after an empty slot, so that migration moves whole clusters
+        m_cursor = 0;
+        while (m_old.slots[m_cursor].entry.has_value())
+        {
+            m_cursor++;
+        }
+        m_cursor = (m_cursor + 1) & m_old.mask();
+        m_migrated = 0;
+    }
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A concurrent hash map, built from lock-striped open addressing hash tables
+//!
+//! The keys are partitioned between @p v_Shards cache-padded shards, each of which is an open
+//! addressing hash table guarded by a std::shared_mutex. Lookups take a shared lock, so they only
+//! wait for writers to the same shard. When a shard fills up, only that shard is rehashed, while
+//! the rest of the map stays available.
+//!
+//! Callables passed to upsert() and with() run while their shard is locked, so they should be
+//! short, and must not access the map. If one throws, its shard is poisoned, just like a Mutex, and
+//! every access to a key in that shard throws std::runtime_error until clear_poison() or clear() is
+//! called.
+template<typename KeyT,
+         typename MappedT,
+         std::size_t v_Shards = 32,
+         typename HashT = std::hash<KeyT>,
+         typename EqualT = std::equal_to<KeyT>>
+class ConcurrentMap
+{
+    using Table = detail::OpenTable<KeyT, MappedT, EqualT>;
+    using Shards = ShardedMutex<Table, v_Shards, std::shared_mutex>;
+
+  public:
+    //! Copy the value mapped to @p key, if there is one
+    [[nodiscard]] std::optional<MappedT> get(const KeyT& key) const
+    {
+        return with(key, [](const MappedT& value) { return value; });
+    }
+
+    [[nodiscard]] bool contains(const KeyT& key) const
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = std::as_const(shard_of(hash)).lock();
+        return table->find(hash, key) != nullptr;
+    }
+
+    //! Insert @p value, unless @p key is already present
+    //!
+    //! @returns whether the value was inserted
+    bool insert(KeyT key, MappedT value)
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = shard_of(hash).lock();
+        return table->try_emplace(hash, std::move(key), std::move(value)).second;
+    }
+
+    //! Insert @p value, or assign it if @p key is already present
+    void insert_or_assign(KeyT key, MappedT value)
+    {
+        upsert(std::move(key), [&value](MappedT& mapped) { mapped = std::move(value); });
+    }
+
+    //! Call @p function on the value mapped to @p key, default constructing it if necessary
+    //!
+    //! @returns the result of @p function
+    template<typename FunctionT>
+    decltype(auto) upsert(KeyT key, FunctionT&& function)
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = shard_of(hash).lock();
+        MappedT* value = table->try_emplace(hash, std::move(key)).first;
+        return std::invoke(std::forward<FunctionT>(function), *value);
+    }
+
+    //! Call @p function on the value mapped to @p key, if there is one
+    //!
+    //! @returns whether @p function was called, or an optional of its result if it has one
+    template<typename FunctionT>
+    detail::MaybeResult<std::invoke_result_t<FunctionT, MappedT&>> with(const KeyT& key,
+                                                                        FunctionT&& function)
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = shard_of(hash).lock();
+        if (MappedT* value = table->find(hash, key); value != nullptr)
+        {
+            return detail::invoke_maybe(std::forward<FunctionT>(function), *value);
+        }
+        return {};
+    }
+
+    //! Call @p function on the value mapped to @p key, if there is one, under a shared lock
+    //!
+    //! @returns whether @p function was called, or an optional of its result if it has one
+    template<typename FunctionT>
+    detail::MaybeResult<std::invoke_result_t<FunctionT, const MappedT&>>
+    with(const KeyT& key, FunctionT&& function) const
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = shard_of(hash).lock();
+        if (const MappedT* value = table->find(hash, key); value != nullptr)
+        {
+            return detail::invoke_maybe(std::forward<FunctionT>(function), *value);
+        }
+        return {};
+    }
+
+    //! @returns whether @p key was present
+    bool erase(const KeyT& key)
+    {
+        const std::uint64_t hash = hash_of(key);
+        auto table = shard_of(hash).lock();
+        return table->erase(hash, key);
+    }
+
+    //! The number of entries in the map
+    //!
+    //! @note The shards are counted one at a time, so this is only a snapshot if no other thread
+    //! is modifying the map.
+    [[nodiscard]] std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < v_Shards; i++)
+        {
+            total += m_shards.shard(i).lock()->size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    //! Call @p function on each key and value, locking one shard at a time
+    template<typename FunctionT>
+    void for_each(FunctionT&& function) const
+    {
+        for (std::size_t i = 0; i < v_Shards; i++)
+        {
+            m_shards.shard(i).lock()->for_each(function);
+        }
+    }
+
+    //! Remove every entry, locking one shard at a time
+    //!
+    //! Poisoned shards are cleared too, and their poison cleared along with their entries.
+    void clear() noexcept
+    {
+        for (std::size_t i = 0; i < v_Shards; i++)
+        {
+            auto& shard = m_shards.shard(i);
+            auto guard = shard.lock_unchecked();
+            guard->clear();
+            shard.clear_poison();
+        }
+    }
+
+    //! Indicates whether any shard has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_shards.is_poisoned(); }
+
+    //! Clear the poisoned state of every shard, keeping their entries as the callables that threw
+    //! left them
+    //!
+    //! Each shard is locked while its poison is cleared, so this waits for any callable running on
+    //! it, and can't lose a poisoning that happens concurrently.
+    void clear_poison() noexcept
+    {
+        for (std::size_t i = 0; i < v_Shards; i++)
+        {
+            auto& shard = m_shards.shard(i);
+            auto guard = shard.lock_unchecked();
+            shard.clear_poison();
+        }
+    }
+
+  private:
+    Shards m_shards;
+
+    [[nodiscard]] static std::uint64_t hash_of(const KeyT& key) noexcept
+    {
+        return detail::mix_hash(HashT{}(key));
+    }
+
+    [[nodiscard]] typename Shards::Shard& shard_of(std::uint64_t hash) noexcept
+    {
+        return m_shards.shard(Shards::shard_index_of_hash(hash));
+    }
+
+    [[nodiscard]] const typename Shards::Shard& shard_of(std::uint64_t hash) const noexcept
+    {
+        return m_shards.shard(Shards::shard_index_of_hash(hash));
+    }
+};
+
+}  // namespace rmx
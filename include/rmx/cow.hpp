@@ -0,0 +1,185 @@
+#pragma once
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! An RAII-style guard for writing to a CowMutex
+//!
+//! If no snapshots of the value are outstanding, the guard mutates the value in place. Otherwise,
+//! it mutates a copy, which replaces the current version when the guard goes out of scope. If the
+//! guard goes out of scope because of an exception, the copy is discarded, but mutations made in
+//! place poison the CowMutex.
+//!
+//! Acquire a `CowGuard` by calling `CowMutex::write()`.
+template<typename ValueT>
+class CowGuard
+{
+  public:
+    explicit CowGuard(std::shared_ptr<ValueT>& current,
+                      std::unique_lock<std::mutex>&& lock,
+                      bool& was_poisoned) noexcept(false) :
+        m_lock(std::move(lock)),
+        m_current(current),
+        m_was_poisoned(was_poisoned),
+        m_exceptions(std::uncaught_exceptions())
+    {
+        // Snapshots can only be taken with the lock held, so the count can't grow behind our back,
+        // as long as no snapshot was turned into a std::weak_ptr, which could be locked without it
+        if (current.use_count() != 1)
+        {
+            m_copy = std::make_shared<ValueT>(std::as_const(*current));
+        } else
+        {
+            // Synchronize with the release of the last snapshot, so its reads happen before our
+            // writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+    }
+
+    CowGuard(CowGuard&&) noexcept = default;
+    CowGuard& operator=(CowGuard&&) noexcept = default;
+
+    CowGuard(const CowGuard&) = delete;
+    CowGuard& operator=(const CowGuard&) = delete;
+
+    //! Publish the copy, or poison the CowMutex if the value was mutated in place and the guard
+    //! is being destructed by an exception
+    ~CowGuard()
+    {
+        if (!m_lock.owns_lock())
+        {
+            return;
+        }
+        if (std::uncaught_exceptions() > m_exceptions)
+        {
+            if (!m_copy)
+            {
+                m_was_poisoned.get() = true;
+            }
+        } else if (m_copy)
+        {
+            m_current.get() = std::move(m_copy);
+        }
+    }
+
+    //! Access the value being written by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] ValueT& operator*() noexcept { return target(); }
+    [[nodiscard]] const ValueT& operator*() const noexcept { return target(); }
+
+    //! Access the value being written by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] ValueT* operator->() noexcept { return &target(); }
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &target(); }
+
+    //! Indicates whether this guard is writing to a copy, because snapshots were outstanding
+    [[nodiscard]] bool is_copy() const noexcept { return m_copy != nullptr; }
+
+  private:
+    std::unique_lock<std::mutex> m_lock;
+    std::reference_wrapper<std::shared_ptr<ValueT>> m_current;
+    std::reference_wrapper<bool> m_was_poisoned;
+    std::shared_ptr<ValueT> m_copy;
+    int m_exceptions;
+
+    ValueT& target() const noexcept { return m_copy ? *m_copy : *m_current.get(); }
+};
+
+//! A copy-on-write mutex, whose readers take immutable snapshots of the value
+//!
+//! A snapshot keeps its version of the value alive for as long as it's held, without holding any
+//! lock, so long-running readers never block writers. Writers copy the value only when a snapshot
+//! of the current version is outstanding, and otherwise mutate it in place.
+//!
+//! @note Taking a snapshot briefly locks the CowMutex, so it waits for an in-progress write.
+//!
+//! @warning Don't make a std::weak_ptr from a snapshot. Locking it would take a new reference to
+//! the current version without the CowMutex's lock, which a writer that already decided to mutate
+//! the value in place can't see.
+template<typename ValueT>
+class CowMutex
+{
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit CowMutex(ValueT&& value) : m_current(std::make_shared<ValueT>(std::move(value))) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit CowMutex(ArgsT&&... args) :
+        m_current(std::make_shared<ValueT>(std::forward<ArgsT>(args)...))
+    {
+    }
+
+    //! Take an immutable snapshot of the current version of the value
+    //!
+    //! @warning The snapshot must not be observed through a std::weak_ptr. See CowMutex.
+    //!
+    //! @throws std::runtime_error if the CowMutex has been poisoned.
+    [[nodiscard]] std::shared_ptr<const ValueT> snapshot() const noexcept(false)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        throw_if_poisoned();
+        return m_current;
+    }
+
+    //! Take an immutable snapshot of the current version of the value, without checking for
+    //! poison
+    //!
+    //! @warning The snapshot must not be observed through a std::weak_ptr. See CowMutex.
+    [[nodiscard]] std::shared_ptr<const ValueT> snapshot_unchecked() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_current;
+    }
+
+    //! Lock the CowMutex for writing, and return an RAII guard controlling access to the value
+    //!
+    //! @throws std::runtime_error if the CowMutex has been poisoned.
+    [[nodiscard]] CowGuard<ValueT> write() noexcept(false)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        throw_if_poisoned();
+        return CowGuard(m_current, std::move(lock), m_was_poisoned);
+    }
+
+    //! Lock the CowMutex for writing, without checking for poison
+    //!
+    //! @note Copying the value may still throw.
+    [[nodiscard]] CowGuard<ValueT> write_unchecked() noexcept(false)
+    {
+        return CowGuard(m_current, std::unique_lock<std::mutex>(m_mutex), m_was_poisoned);
+    }
+
+    //! Indicates whether this CowMutex has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_was_poisoned; }
+
+    //! Clear the poisoned state of this CowMutex
+    //!
+    //! Use this after recovering the value into a consistent state through write_unchecked().
+    void clear_poison() noexcept { m_was_poisoned = false; }
+
+  private:
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::shared_ptr<ValueT> m_current;
+    bool m_was_poisoned = false;
+};
+
+}  // namespace rmx
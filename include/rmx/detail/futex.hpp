@@ -0,0 +1,125 @@
+#pragma once
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+namespace rmx::detail {
+//! Whether a futex word may be shared between processes, or only between threads
+enum class FutexScope
+{
+    Private,
+    Shared,
+};
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+              "A futex word must be exactly 32 bits");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "A futex word must be lock free");
+
+//! Sleep until woken, as long as @p word holds @p expected
+//!
+//! @note Spurious wakeups are possible, so callers must re-check their wait condition.
+inline void futex_wait(const std::atomic<std::uint32_t>& word,
+                       std::uint32_t expected,
+                       FutexScope scope = FutexScope::Private) noexcept
+{
+    const int op = scope == FutexScope::Shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    syscall(SYS_futex, &word, op, expected, nullptr, nullptr, 0);
+}
+
+//! Sleep until woken or @p timeout elapses, as long as @p word holds @p expected
+//!
+//! @returns false if the timeout elapsed
+inline bool futex_wait_for(const std::atomic<std::uint32_t>& word,
+                           std::uint32_t expected,
+                           std::chrono::nanoseconds timeout,
+                           FutexScope scope = FutexScope::Private) noexcept
+{
+    if (timeout <= std::chrono::nanoseconds::zero())
+    {
+        return false;
+    }
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec relative{};
+    relative.tv_sec = static_cast<std::time_t>(seconds.count());
+    relative.tv_nsec = static_cast<long>((timeout - seconds).count());
+
+    const int op = scope == FutexScope::Shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    const long result = syscall(SYS_futex, &word, op, expected, &relative, nullptr, 0);
+    return !(result == -1 && errno == ETIMEDOUT);
+}
+
+//! Wake up to @p count threads sleeping on @p word
+inline void futex_wake(const std::atomic<std::uint32_t>& word,
+                       int count,
+                       FutexScope scope = FutexScope::Private) noexcept
+{
+    const int op = scope == FutexScope::Shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+    syscall(SYS_futex, &word, op, count, nullptr, nullptr, 0);
+}
+
+//! Wake every thread sleeping on @p word
+inline void futex_wake_all(const std::atomic<std::uint32_t>& word,
+                           FutexScope scope = FutexScope::Private) noexcept
+{
+    futex_wake(word, INT_MAX, scope);
+}
+
+//! Hint to the CPU that we're in a spin-wait loop
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+//! Lets threads sleep until a condition they're polling might have changed, without a lock
+//!
+//! A waiter calls prepare_wait(), re-checks its condition, and then either calls cancel_wait() or
+//! wait(). A notifier makes the condition true, and then calls notify_one() or notify_all(), which
+//! only make a syscall if there are waiters.
+class EventCount
+{
+  public:
+    [[nodiscard]] std::uint32_t prepare_wait() noexcept
+    {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    void cancel_wait() noexcept { m_waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+    //! Sleep until notified, unless a notification has happened since @p epoch was prepared
+    void wait(std::uint32_t epoch) noexcept
+    {
+        futex_wait(m_epoch, epoch);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() noexcept { notify(1); }
+    void notify_all() noexcept { notify(INT_MAX); }
+
+  private:
+    void notify(int count) noexcept
+    {
+        // Order the condition the notifier changed before the check for waiters
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(m_epoch, count);
+        }
+    }
+
+    std::atomic<std::uint32_t> m_epoch{0};
+    std::atomic<std::uint32_t> m_waiters{0};
+};
+}  // namespace rmx::detail
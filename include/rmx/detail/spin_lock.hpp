@@ -0,0 +1,46 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+
+#include <atomic>
+#include <thread>
+
+namespace rmx::detail {
+//! A test-and-test-and-set spin lock
+class SpinLock
+{
+  public:
+    void lock() noexcept
+    {
+        for (unsigned spins = 0; !try_lock(); spins++)
+        {
+            backoff(spins);
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        // Only attempt to take the cache line exclusively if the lock looks free
+        return !m_locked.load(std::memory_order_relaxed) &&
+               !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept { m_locked.store(false, std::memory_order_release); }
+
+    //! Wait out one iteration of a spin loop, yielding the CPU once spinning has gone on for long
+    static void backoff(unsigned spins) noexcept
+    {
+        if (spins < max_spins)
+        {
+            cpu_relax();
+        } else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+  private:
+    static constexpr unsigned max_spins = 128;
+
+    std::atomic<bool> m_locked{false};
+};
+}  // namespace rmx::detail
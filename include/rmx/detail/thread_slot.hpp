@@ -0,0 +1,13 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace rmx::detail {
+//! A small, stable index for the calling thread, used to spread threads over slots
+inline std::size_t thread_slot() noexcept
+{
+    static std::atomic<std::size_t> next_slot{0};
+    thread_local const std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+}  // namespace rmx::detail
@@ -0,0 +1,145 @@
+#pragma once
+#include <rmx/rmx.hpp>
+
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! Detects whether @p ValueT has a `clear()` method, like the standard containers
+template<typename ValueT, typename = void>
+struct IsClearable : std::false_type
+{
+};
+
+template<typename ValueT>
+struct IsClearable<ValueT, std::void_t<decltype(std::declval<ValueT&>().clear())>> : std::true_type
+{
+};
+
+//! Empty @p buffer, keeping any capacity it has allocated if possible
+template<typename ValueT>
+void clear_buffer(ValueT& buffer)
+{
+    if constexpr (IsClearable<ValueT>::value)
+    {
+        buffer.clear();
+    } else
+    {
+        buffer = ValueT{};
+    }
+}
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A buffer that producers accumulate into, and that a consumer swaps out wholesale
+//!
+//! Producers lock the active buffer like any other Mutex. The consumer hands over a spare buffer,
+//! which is cleared before the lock is taken, and receives the full one in exchange, so the
+//! consumer's critical section is a single swap, and no buffer is ever reallocated.
+//!
+//! @code
+//! rmx::DoubleBuffer<std::vector<Sample>> samples;
+//! samples.lock()->push_back(sample);
+//!
+//! std::vector<Sample> batch;
+//! samples.swap(batch);
+//! @endcode
+template<typename ValueT, typename MutexImplT = std::mutex>
+class DoubleBuffer
+{
+    static_assert(std::is_nothrow_swappable_v<ValueT>, "DoubleBuffer requires a nothrow swap");
+
+  public:
+    //! Construct the active buffer from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit DoubleBuffer(ArgsT&&... args) : m_active(std::forward<ArgsT>(args)...)
+    {
+    }
+
+    //! Lock the active buffer
+    //!
+    //! @throws std::runtime_error if the DoubleBuffer has been poisoned.
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock() noexcept(false) { return m_active.lock(); }
+
+    //! Lock the active buffer, without checking for poison
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock_unchecked() noexcept
+    {
+        return m_active.lock_unchecked();
+    }
+
+    //! Attempt to lock the active buffer
+    //!
+    //! @throws std::runtime_error if the DoubleBuffer has been poisoned.
+    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT>> try_lock() noexcept(false)
+    {
+        return m_active.try_lock();
+    }
+
+    //! Lock the active buffer, and invoke @p function on it
+    //!
+    //! @throws std::runtime_error if the DoubleBuffer has been poisoned.
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with(FunctionT&& function) noexcept(false)
+    {
+        return m_active.with(std::forward<FunctionT>(function));
+    }
+
+    //! Clear @p buffer, and swap it with the active buffer
+    //!
+    //! Only the swap itself happens under the lock.
+    //!
+    //! @throws std::runtime_error if the DoubleBuffer has been poisoned, in which case @p buffer
+    //! has been cleared but not swapped.
+    void swap(ValueT& buffer) noexcept(false)
+    {
+        detail::clear_buffer(buffer);
+        auto active = m_active.lock();
+        using std::swap;
+        swap(*active, buffer);
+    }
+
+    //! Clear @p buffer, and swap it with the active buffer, without checking for poison
+    //!
+    //! @note This doesn't clear the poison, even though the active buffer is replaced.
+    void swap_unchecked(ValueT& buffer)
+    {
+        detail::clear_buffer(buffer);
+        auto active = m_active.lock_unchecked();
+        using std::swap;
+        swap(*active, buffer);
+    }
+
+    //! Swap a new, empty buffer for the active buffer, and return the active buffer
+    //!
+    //! Prefer swap() to reuse the consumer's buffer.
+    //!
+    //! @throws std::runtime_error if the DoubleBuffer has been poisoned.
+    [[nodiscard]] ValueT take() noexcept(false)
+    {
+        ValueT buffer{};
+        swap(buffer);
+        return buffer;
+    }
+
+    //! Indicates whether this DoubleBuffer has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_active.is_poisoned(); }
+
+    //! Clear the poisoned state of this DoubleBuffer
+    //!
+    //! The active buffer is locked while its poison is cleared, so don't call this while holding a
+    //! guard on it.
+    void clear_poison() noexcept
+    {
+        auto active = m_active.lock_unchecked();
+        m_active.clear_poison();
+    }
+
+  private:
+    Mutex<ValueT, MutexImplT, CachePadded> m_active;
+};
+
+}  // namespace rmx
@@ -0,0 +1,284 @@
+#pragma once
+#include <rmx/detail/spin_lock.hpp>
+#include <rmx/detail/thread_slot.hpp>
+#include <rmx/rmx.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! Counts the readers of one version of a LeftRight, with a separate cache line for each slot so
+//! that readers on different threads don't write to the same line
+template<std::size_t v_Slots>
+class ReadIndicator
+{
+  public:
+    void arrive(std::size_t slot) noexcept
+    {
+        m_slots[slot].m_readers.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    void depart(std::size_t slot) noexcept
+    {
+        m_slots[slot].m_readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool is_empty() const noexcept
+    {
+        for (const Slot& slot : m_slots)
+        {
+            if (slot.m_readers.load(std::memory_order_seq_cst) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void wait_until_empty() const noexcept
+    {
+        for (unsigned spins = 0; !is_empty(); spins++)
+        {
+            SpinLock::backoff(spins);
+        }
+    }
+
+  private:
+    struct alignas(hardware_destructive_interference_size) Slot
+    {
+        std::atomic<std::uint32_t> m_readers{0};
+    };
+
+    std::array<Slot, v_Slots> m_slots;
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! An RAII-style guard wrapping a read-only reference to one copy of the value in a LeftRight
+//!
+//! Acquire a `LeftRightReadGuard` by reading a `LeftRight`.
+template<typename ValueT, std::size_t v_ReadSlots>
+class LeftRightReadGuard
+{
+  public:
+    explicit LeftRightReadGuard(const ValueT& value_ref,
+                                detail::ReadIndicator<v_ReadSlots>& indicator,
+                                std::size_t slot) noexcept :
+        m_ref(value_ref), m_indicator(&indicator), m_slot(slot)
+    {
+    }
+
+    LeftRightReadGuard(LeftRightReadGuard&& other) noexcept :
+        m_ref(other.m_ref),
+        m_indicator(std::exchange(other.m_indicator, nullptr)),
+        m_slot(other.m_slot)
+    {
+    }
+    LeftRightReadGuard& operator=(LeftRightReadGuard&&) = delete;
+
+    LeftRightReadGuard(const LeftRightReadGuard&) = delete;
+    LeftRightReadGuard& operator=(const LeftRightReadGuard&) = delete;
+
+    ~LeftRightReadGuard()
+    {
+        if (m_indicator != nullptr)
+        {
+            m_indicator->depart(m_slot);
+        }
+    }
+
+    //! Access the underlying value by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] const ValueT& operator*() const noexcept { return m_ref; }
+
+    //! Access the underlying value by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &m_ref.get(); }
+
+  private:
+    std::reference_wrapper<const ValueT> m_ref;
+    detail::ReadIndicator<v_ReadSlots>* m_indicator;
+    std::size_t m_slot;
+};
+
+//! A left-right concurrency primitive, with wait-free readers
+//!
+//! Two copies of the value are kept. Readers are routed to whichever copy isn't being written, and
+//! writers apply each operation to both copies in turn, waiting for readers to drain from a copy
+//! before writing to it. Reading never waits, and only writes to one of @p v_ReadSlots cache lines
+//! that it shares with few, if any, other threads.
+//!
+//! Write operations must be deterministic, because they're applied to each copy separately.
+template<typename ValueT, std::size_t v_ReadSlots = 32>
+class LeftRight
+{
+    static_assert(v_ReadSlots > 0, "A LeftRight needs at least one read slot");
+
+  public:
+    //! Take ownership of an existing @p ValueT, and copy it
+    explicit LeftRight(ValueT&& value) : m_left(std::move(value)), m_right(m_left) {}
+
+    //! Construct a new @p ValueT from the given args, and copy it, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit LeftRight(ArgsT&&... args) : m_left{std::forward<ArgsT>(args)...}, m_right(m_left)
+    {
+    }
+
+    LeftRight(const LeftRight&) = delete;
+    LeftRight& operator=(const LeftRight&) = delete;
+
+    //! Return an RAII guard providing read-only access to a stable copy of the value, without
+    //! waiting
+    //!
+    //! @warning Holding a read guard blocks writers, which wait for readers to leave the copy
+    //! they're about to write to.
+    //!
+    //! Readers always see a complete copy, even after poisoning, since only the copy readers have
+    //! been routed away from is ever left broken. Reading still checks for poison, like locking a
+    //! `const Mutex` does, so that a failed write is noticed by readers as well as writers. Use
+    //! read_unchecked() to keep reading the readable copy regardless.
+    //!
+    //! @throws std::runtime_error if the LeftRight has been poisoned.
+    [[nodiscard]] LeftRightReadGuard<ValueT, v_ReadSlots> read() const noexcept(false)
+    {
+        throw_if_poisoned();
+        return read_unchecked();
+    }
+
+    //! Return an RAII guard providing read-only access to a stable copy of the value, without
+    //! waiting, or checking for poison
+    [[nodiscard]] LeftRightReadGuard<ValueT, v_ReadSlots> read_unchecked() const noexcept
+    {
+        const std::size_t slot = detail::thread_slot() % v_ReadSlots;
+        auto& indicator = m_indicators[m_version.load(std::memory_order_seq_cst)];
+        indicator.arrive(slot);
+        const ValueT& value = instance(m_readable.load(std::memory_order_seq_cst));
+        return LeftRightReadGuard<ValueT, v_ReadSlots>(value, indicator, slot);
+    }
+
+    //! Apply @p operation to both copies of the value, and return its result
+    //!
+    //! If @p operation throws on the first copy, that copy is restored from the other one, so the
+    //! write has no effect, and the exception propagates. If it throws on the second copy, readers
+    //! already see the first, so the second is brought up to date from it instead: the write takes
+    //! effect as applied to the first copy, and the exception still propagates. If a copy can't be
+    //! restored, the LeftRight is poisoned.
+    //!
+    //! @throws std::runtime_error if the LeftRight has been poisoned.
+    template<typename OperationT>
+    std::invoke_result_t<OperationT&, ValueT&> write(OperationT&& operation) noexcept(false)
+    {
+        std::lock_guard<std::mutex> lock(m_writer);
+        throw_if_poisoned();
+        return apply(operation);
+    }
+
+    //! Apply @p operation to both copies of the value, without checking for poison
+    template<typename OperationT>
+    std::invoke_result_t<OperationT&, ValueT&> write_unchecked(OperationT&& operation)
+    {
+        std::lock_guard<std::mutex> lock(m_writer);
+        return apply(operation);
+    }
+
+    //! Indicates whether this LeftRight has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept
+    {
+        return m_was_poisoned.load(std::memory_order_relaxed);
+    }
+
+    //! Clear the poisoned state of this LeftRight
+    //!
+    //! Use this after bringing both copies back into the same state through write_unchecked().
+    void clear_poison() noexcept { m_was_poisoned.store(false, std::memory_order_relaxed); }
+
+  private:
+    ValueT& instance(std::uint32_t index) noexcept { return index == 0 ? m_left : m_right; }
+    const ValueT& instance(std::uint32_t index) const noexcept
+    {
+        return index == 0 ? m_left : m_right;
+    }
+
+    template<typename OperationT>
+    std::invoke_result_t<OperationT&, ValueT&> apply(OperationT& operation) noexcept(false)
+    {
+        static_assert(!std::is_reference_v<std::invoke_result_t<OperationT&, ValueT&>>,
+                      "References to one copy of the value must not escape the LeftRight");
+
+        const std::uint32_t readable = m_readable.load(std::memory_order_relaxed);
+        try
+        {
+            std::invoke(operation, instance(1 - readable));
+        } catch (...)
+        {
+            restore(1 - readable);
+            throw;
+        }
+
+        m_readable.store(1 - readable, std::memory_order_seq_cst);
+        toggle_version_and_wait();
+
+        // No reader can see this copy anymore. The write is already visible, so a failure from
+        // here on commits it, rather than rolling it back.
+        try
+        {
+            return std::invoke(operation, instance(readable));
+        } catch (...)
+        {
+            restore(readable);
+            throw;
+        }
+    }
+
+    //! Wait until no readers can be reading the copy that readers were routed away from
+    void toggle_version_and_wait() noexcept
+    {
+        const std::uint32_t previous = m_version.load(std::memory_order_relaxed);
+        const std::uint32_t next = 1 - previous;
+        m_indicators[next].wait_until_empty();
+        m_version.store(next, std::memory_order_seq_cst);
+        m_indicators[previous].wait_until_empty();
+    }
+
+    //! Bring the unreadable copy at @p index back in line with the readable copy
+    void restore(std::uint32_t index) noexcept
+    {
+        try
+        {
+            instance(index) = instance(1 - index);
+        } catch (...)
+        {
+            m_was_poisoned.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("LeftRight poisoned: failed to restore a copy of the value");
+        }
+    }
+
+    // Readers only load these, so keep them off the cache lines that writers write to
+    alignas(hardware_destructive_interference_size) std::atomic<std::uint32_t> m_readable{0};
+    std::atomic<std::uint32_t> m_version{0};
+    std::atomic<bool> m_was_poisoned{false};
+    mutable std::array<detail::ReadIndicator<v_ReadSlots>, 2> m_indicators;
+    std::mutex m_writer;
+    alignas(hardware_destructive_interference_size) ValueT m_left;
+    alignas(hardware_destructive_interference_size) ValueT m_right;
+};
+
+}  // namespace rmx
@@ -0,0 +1,330 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+#include <rmx/rmx.hpp>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rmx::detail {
+//! A fair, thread-oblivious spin-then-sleep lock
+//!
+//! Unlike std::mutex, a TicketLock may be unlocked by a different thread than the one that locked
+//! it, and can tell whether there are other threads waiting for it.
+class TicketLock
+{
+  public:
+    void lock() noexcept
+    {
+        const std::uint32_t ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0; spins < max_spins; spins++)
+        {
+            if (m_serving.load(std::memory_order_acquire) == ticket)
+            {
+                return;
+            }
+            cpu_relax();
+        }
+
+        for (;;)
+        {
+            const std::uint32_t serving = m_serving.load(std::memory_order_acquire);
+            if (serving == ticket)
+            {
+                return;
+            }
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            futex_wait(m_serving, serving);
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        std::uint32_t serving = m_serving.load(std::memory_order_relaxed);
+        return m_next.compare_exchange_strong(
+            serving, serving + 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        m_serving.fetch_add(1, std::memory_order_seq_cst);
+        // Tickets are served in order, so every sleeper has to check whether it's their turn
+        if (m_sleepers.load(std::memory_order_seq_cst) != 0)
+        {
+            futex_wake_all(m_serving);
+        }
+    }
+
+    //! Indicates whether other threads are waiting for the lock
+    //!
+    //! @note Only the current owner of the lock may call this method.
+    [[nodiscard]] bool has_waiters() const noexcept
+    {
+        // The owner holds one of the outstanding tickets
+        return queued() > 1;
+    }
+
+    //! The number of threads holding or waiting for the lock
+    [[nodiscard]] std::uint32_t queued() const noexcept
+    {
+        return m_next.load(std::memory_order_relaxed) - m_serving.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr int max_spins = 128;
+
+    std::atomic<std::uint32_t> m_next{0};
+    std::atomic<std::uint32_t> m_serving{0};
+    std::atomic<std::uint32_t> m_sleepers{0};
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A mapping of CPUs to the NUMA nodes they belong to
+class NumaTopology
+{
+  public:
+    //! Returns the NUMA node of the calling thread
+    using CurrentNodeFunction = std::size_t (*)() noexcept;
+
+    //! Construct a topology where CPU `i` belongs to NUMA node `node_of_cpu[i]`
+    //!
+    //! Use this to override the system topology in tests.
+    explicit NumaTopology(std::vector<std::size_t> node_of_cpu) :
+        m_node_of_cpu(std::move(node_of_cpu))
+    {
+        for (const std::size_t node : m_node_of_cpu)
+        {
+            m_node_count = std::max(m_node_count, node + 1);
+        }
+    }
+
+    //! Construct a topology of @p node_count nodes, where @p current_node_function reports the
+    //! calling thread's node
+    //!
+    //! Use this to place threads on fake nodes in tests, whichever CPUs they actually run on.
+    NumaTopology(std::size_t node_count, CurrentNodeFunction current_node_function) noexcept :
+        m_node_count(std::max<std::size_t>(node_count, 1)), m_current_node(current_node_function)
+    {
+    }
+
+    //! Discover the topology from sysfs, or fall back to a single node if it's unavailable
+    [[nodiscard]] static NumaTopology
+    discover(const std::filesystem::path& sysfs = "/sys/devices/system/node")
+    {
+        std::vector<std::size_t> node_of_cpu;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(sysfs, error))
+        {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos || name.size() == 4)
+            {
+                continue;
+            }
+            const std::size_t node = std::stoul(name.substr(4));
+
+            std::ifstream file(entry.path() / "cpulist");
+            std::string cpulist;
+            std::getline(file, cpulist);
+            for (const std::size_t cpu : parse_cpulist(cpulist))
+            {
+                if (cpu >= node_of_cpu.size())
+                {
+                    node_of_cpu.resize(cpu + 1, 0);
+                }
+                node_of_cpu[cpu] = node;
+            }
+        }
+        return NumaTopology(std::move(node_of_cpu));
+    }
+
+    //! The topology of this system, discovered once
+    [[nodiscard]] static const NumaTopology& system()
+    {
+        static const NumaTopology topology = discover();
+        return topology;
+    }
+
+    //! Parse a sysfs CPU list like "0-3,8,10-11"
+    //!
+    //! @throws std::invalid_argument if the list is malformed
+    [[nodiscard]] static std::vector<std::size_t> parse_cpulist(std::string_view cpulist)
+    {
+        std::vector<std::size_t> cpus;
+        while (!cpulist.empty() && cpulist.back() == '\n')
+        {
+            cpulist.remove_suffix(1);
+        }
+        while (!cpulist.empty())
+        {
+            const std::size_t comma = cpulist.find(',');
+            const std::string range(cpulist.substr(0, comma));
+            cpulist = comma == std::string_view::npos ? std::string_view{}
+                                                      : cpulist.substr(comma + 1);
+
+            const std::size_t dash = range.find('-');
+            const std::size_t first = std::stoul(range.substr(0, dash));
+            const std::size_t last =
+                dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+            if (last < first)
+            {
+                throw std::invalid_argument("Invalid CPU range: " + range);
+            }
+            for (std::size_t cpu = first; cpu <= last; cpu++)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    [[nodiscard]] std::size_t node_count() const noexcept { return m_node_count; }
+
+    //! The NUMA node of the given CPU, or node 0 for unknown CPUs
+    [[nodiscard]] std::size_t node_of(int cpu) const noexcept
+    {
+        if (cpu < 0 || static_cast<std::size_t>(cpu) >= m_node_of_cpu.size())
+        {
+            return 0;
+        }
+        return m_node_of_cpu[static_cast<std::size_t>(cpu)];
+    }
+
+    //! The NUMA node of the CPU the calling thread is currently running on
+    //!
+    //! Always less than node_count(). A node reported out of range is treated as node 0, like an
+    //! unknown CPU in node_of().
+    [[nodiscard]] std::size_t current_node() const noexcept
+    {
+        const std::size_t node =
+            m_current_node != nullptr ? m_current_node() : node_of(sched_getcpu());
+        return node < m_node_count ? node : 0;
+    }
+
+  private:
+    std::vector<std::size_t> m_node_of_cpu;
+    std::size_t m_node_count = 1;
+    CurrentNodeFunction m_current_node = nullptr;
+};
+
+//! A NUMA-aware cohort lock, that prefers handing the lock to a waiter on the same NUMA node
+//!
+//! Handing a lock (and the data it protects) between sockets is much more expensive than handing
+//! it between cores on the same socket. A CohortMutex is built from a global lock, and a local lock
+//! per NUMA node. A thread takes its node's local lock, and then the global lock. When it unlocks,
+//! if another thread is waiting on the same node, it passes the global lock to them directly. To
+//! keep other nodes from starving, at most `max_local_handoffs` consecutive handoffs are made
+//! before the global lock is released.
+//!
+//! @code
+//! rmx::Mutex<State, rmx::CohortMutex> mutex;
+//! @endcode
+class CohortMutex
+{
+  public:
+    static constexpr std::uint32_t default_max_local_handoffs = 64;
+
+    CohortMutex() : CohortMutex(NumaTopology::system()) {}
+
+    //! @warning The @p topology must outlive the CohortMutex.
+    explicit CohortMutex(const NumaTopology& topology,
+                         std::uint32_t max_local_handoffs = default_max_local_handoffs) :
+        m_topology(&topology),
+        m_nodes(std::make_unique<Node[]>(topology.node_count())),
+        m_max_local_handoffs(max_local_handoffs)
+    {
+    }
+
+    void lock() noexcept
+    {
+        const std::size_t node = m_topology->current_node();
+        Node& local = m_nodes[node];
+        local.lock.lock();
+        if (!local.global_passed)
+        {
+            m_global.lock();
+        }
+        m_holder_node = node;
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        const std::size_t node = m_topology->current_node();
+        Node& local = m_nodes[node];
+        if (!local.lock.try_lock())
+        {
+            return false;
+        }
+        if (!local.global_passed && !m_global.try_lock())
+        {
+            local.lock.unlock();
+            return false;
+        }
+        m_holder_node = node;
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        Node& local = m_nodes[m_holder_node];
+        if (local.lock.has_waiters() && local.handoffs < m_max_local_handoffs)
+        {
+            local.handoffs++;
+            local.global_passed = true;
+        } else
+        {
+            local.handoffs = 0;
+            local.global_passed = false;
+            m_global.unlock();
+        }
+        local.lock.unlock();
+    }
+
+    //! The number of threads holding or waiting for the given node's local lock
+    //!
+    //! @note This is a snapshot, for diagnostics and tests.
+    [[nodiscard]] std::uint32_t queued(std::size_t node) const noexcept
+    {
+        return m_nodes[node].lock.queued();
+    }
+
+    //! The number of threads holding or waiting for the global lock
+    //!
+    //! @note This is a snapshot, for diagnostics and tests. While the global lock is passed between
+    //! threads on one node, it counts as held by one thread.
+    [[nodiscard]] std::uint32_t queued_global() const noexcept { return m_global.queued(); }
+
+  private:
+    //! The per-node state, on its own cache line to avoid cross-node false sharing
+    struct alignas(hardware_destructive_interference_size) Node
+    {
+        detail::TicketLock lock;
+        //! Protected by the local lock
+        std::uint32_t handoffs = 0;
+        //! Whether the previous holder on this node passed the global lock on, protected by the
+        //! local lock
+        bool global_passed = false;
+    };
+
+    const NumaTopology* m_topology;
+    std::unique_ptr<Node[]> m_nodes;
+    std::uint32_t m_max_local_handoffs;
+    alignas(hardware_destructive_interference_size) detail::TicketLock m_global;
+    //! The node of the thread holding the global lock, protected by the global lock
+    std::size_t m_holder_node = 0;
+};
+
+}  // namespace rmx
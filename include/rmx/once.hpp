@@ -0,0 +1,203 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! A value that's initialized at most once, typically a lazily initialized singleton
+//!
+//! Once initialized, reading the value costs a single acquire load. Threads that race to initialize
+//! it sleep until the winner is done. If initialization throws, the exception propagates to the
+//! initializing thread, and the OnceLock is poisoned until clear_poison() allows another attempt.
+template<typename ValueT>
+class OnceLock
+{
+  public:
+    OnceLock() noexcept {}
+
+    OnceLock(const OnceLock&) = delete;
+    OnceLock& operator=(const OnceLock&) = delete;
+
+    ~OnceLock()
+    {
+        if (m_state.load(std::memory_order_acquire) == complete)
+        {
+            m_value.~ValueT();
+        }
+    }
+
+    //! Get the value, initializing it with the result of @p function if it hasn't been already
+    //!
+    //! @throws std::runtime_error if the OnceLock has been poisoned. If @p function throws, the
+    //! exception propagates, and poisons the OnceLock.
+    template<typename FunctionT>
+    const ValueT& get_or_init(FunctionT&& function) noexcept(false)
+    {
+        if (m_state.load(std::memory_order_acquire) != complete)
+        {
+            initialize(std::forward<FunctionT>(function));
+        }
+        return m_value;
+    }
+
+    //! Get the value, or nullptr if it hasn't been initialized yet
+    [[nodiscard]] const ValueT* get() const noexcept
+    {
+        if (m_state.load(std::memory_order_acquire) != complete)
+        {
+            return nullptr;
+        }
+        return &m_value;
+    }
+
+    //! Initialize the value with @p value, if it hasn't been already
+    //!
+    //! If another thread is initializing the value, waits for it to finish.
+    //!
+    //! @returns whether the value was initialized with @p value
+    //! @throws std::runtime_error if the OnceLock has been poisoned.
+    bool set(ValueT value) noexcept(false)
+    {
+        if (m_state.load(std::memory_order_acquire) == complete)
+        {
+            return false;
+        }
+        return initialize([&value]() -> ValueT&& { return std::move(value); });
+    }
+
+    //! Indicates whether initializing the value threw an exception
+    [[nodiscard]] bool is_poisoned() const noexcept
+    {
+        return m_state.load(std::memory_order_relaxed) == poisoned;
+    }
+
+    //! Clear the poisoned state of this OnceLock, so that the next caller attempts to initialize
+    //! the value again
+    void clear_poison() noexcept
+    {
+        std::uint32_t expected = poisoned;
+        m_state.compare_exchange_strong(expected, incomplete, std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr std::uint32_t incomplete = 0;
+    static constexpr std::uint32_t running = 1;
+    static constexpr std::uint32_t running_with_waiters = 2;
+    static constexpr std::uint32_t complete = 3;
+    static constexpr std::uint32_t poisoned = 4;
+
+    //! Initialize the value, or wait for another thread to
+    //!
+    //! @returns whether this thread initialized the value
+    template<typename FunctionT>
+    bool initialize(FunctionT&& function) noexcept(false)
+    {
+        std::uint32_t state = m_state.load(std::memory_order_acquire);
+        for (;;)
+        {
+            switch (state)
+            {
+            case complete:
+                return false;
+            case poisoned:
+                throw std::runtime_error(
+                    "OnceLock poisoned: exception thrown while initializing the value");
+            case incomplete:
+                if (m_state.compare_exchange_weak(
+                        state, running, std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    run(std::forward<FunctionT>(function));
+                    return true;
+                }
+                break;
+            case running:
+                if (!m_state.compare_exchange_weak(state,
+                                                   running_with_waiters,
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_acquire))
+                {
+                    break;
+                }
+                [[fallthrough]];
+            default:
+                detail::futex_wait(m_state, running_with_waiters);
+                state = m_state.load(std::memory_order_acquire);
+                break;
+            }
+        }
+    }
+
+    template<typename FunctionT>
+    void run(FunctionT&& function) noexcept(false)
+    {
+        try
+        {
+            ::new (static_cast<void*>(&m_value))
+                ValueT(std::invoke(std::forward<FunctionT>(function)));
+        } catch (...)
+        {
+            finish(poisoned);
+            throw;
+        }
+        finish(complete);
+    }
+
+    void finish(std::uint32_t state) noexcept
+    {
+        if (m_state.exchange(state, std::memory_order_release) == running_with_waiters)
+        {
+            detail::futex_wake_all(m_state);
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{incomplete};
+    union
+    {
+        ValueT m_value;
+    };
+};
+
+//! A value that's initialized by @p FunctionT the first time it's accessed
+//!
+//! See OnceLock for the synchronization and poisoning semantics.
+template<typename ValueT, typename FunctionT = ValueT (*)()>
+class LazyLock
+{
+  public:
+    explicit LazyLock(FunctionT function) : m_function(std::move(function)) {}
+
+    //! Get the value, initializing it if this is the first access
+    //!
+    //! @throws std::runtime_error if the LazyLock has been poisoned. If initialization throws,
+    //! the exception propagates, and poisons the LazyLock.
+    const ValueT& force() noexcept(false) { return m_once.get_or_init(m_function); }
+
+    const ValueT& operator*() noexcept(false) { return force(); }
+    const ValueT* operator->() noexcept(false) { return &force(); }
+
+    //! Get the value, or nullptr if it hasn't been accessed yet
+    [[nodiscard]] const ValueT* get() const noexcept { return m_once.get(); }
+
+    //! Indicates whether initializing the value threw an exception
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_once.is_poisoned(); }
+
+    //! Clear the poisoned state of this LazyLock, so that the next access attempts to initialize
+    //! the value again
+    void clear_poison() noexcept { m_once.clear_poison(); }
+
+  private:
+    OnceLock<ValueT> m_once;
+    FunctionT m_function;
+};
+
+template<typename FunctionT>
+LazyLock(FunctionT) -> LazyLock<std::invoke_result_t<FunctionT&>, FunctionT>;
+
+}  // namespace rmx
@@ -0,0 +1,346 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace rmx {
+
+template<typename ValueT>
+class OneshotSender;
+
+template<typename ValueT>
+class OneshotReceiver;
+
+//! The shared state of a channel that carries a single value from one sender to one receiver
+//!
+//! A lightweight replacement for std::promise and std::future: the value and a single atomic state
+//! word share one allocation, with no mutex or condition variable, and a waiting receiver sleeps on
+//! the state word itself.
+//!
+//! Either call make() to allocate the state, which is freed when both endpoints are dropped, or
+//! declare a Oneshot and call split() to use it as caller-provided storage, which must outlive both
+//! endpoints.
+//!
+//! @code
+//! auto [sender, receiver] = rmx::Oneshot<Reply>::make();
+//! std::thread([sender = std::move(sender)]() mutable { sender.send(handle(request)); }).detach();
+//! Reply reply = receiver.recv();
+//! @endcode
+template<typename ValueT>
+class Oneshot
+{
+  public:
+    using Sender = OneshotSender<ValueT>;
+    using Receiver = OneshotReceiver<ValueT>;
+
+    Oneshot() noexcept {}
+
+    Oneshot(const Oneshot&) = delete;
+    Oneshot& operator=(const Oneshot&) = delete;
+
+    ~Oneshot()
+    {
+        const std::uint32_t state = m_state.load(std::memory_order_acquire);
+        if ((state & value_sent) != 0 && (state & value_taken) == 0)
+        {
+            m_value.~ValueT();
+        }
+    }
+
+    //! Allocate the shared state, and return the sender and receiver for it
+    [[nodiscard]] static std::pair<Sender, Receiver> make() noexcept(false)
+    {
+        auto* oneshot = new Oneshot();
+        oneshot->m_owned = true;
+        return {Sender(*oneshot), Receiver(*oneshot)};
+    }
+
+    //! Return a sender and receiver using this Oneshot as their shared state
+    //!
+    //! @warning Split a Oneshot at most once, and keep it alive until both endpoints are dropped.
+    [[nodiscard]] std::pair<Sender, Receiver> split() noexcept
+    {
+        return {Sender(*this), Receiver(*this)};
+    }
+
+  private:
+    friend Sender;
+    friend Receiver;
+
+    //! The sender has constructed the value
+    static constexpr std::uint32_t value_sent = 1;
+    //! The sender won't send a value, or already has
+    static constexpr std::uint32_t sender_closed = 2;
+    //! The sender won't touch the state again
+    static constexpr std::uint32_t sender_dropped = 4;
+    //! The receiver won't touch the state again
+    static constexpr std::uint32_t receiver_dropped = 8;
+    //! The receiver may be asleep on the state word, and needs waking once the sender closes
+    static constexpr std::uint32_t receiver_waiting = 16;
+    //! The receiver moved the value out and destroyed it
+    static constexpr std::uint32_t value_taken = 32;
+
+    //! Set @p bits, and free the state if both endpoints have now been dropped
+    void drop(std::uint32_t bits, std::uint32_t other_dropped) noexcept
+    {
+        const std::uint32_t previous = m_state.fetch_or(bits, std::memory_order_acq_rel);
+        if ((previous & other_dropped) != 0 && m_owned)
+        {
+            delete this;
+        }
+    }
+
+    std::atomic<std::uint32_t> m_state{0};
+    bool m_owned = false;
+    union
+    {
+        ValueT m_value;
+    };
+};
+
+//! The sending half of a Oneshot
+//!
+//! Dropping the sender without sending a value wakes the receiver, which then throws, just as a
+//! Mutex is poisoned when the thread holding it throws.
+template<typename ValueT>
+class OneshotSender
+{
+  public:
+    explicit OneshotSender(Oneshot<ValueT>& oneshot) noexcept : m_oneshot(&oneshot) {}
+
+    OneshotSender(OneshotSender&& other) noexcept :
+        m_oneshot(std::exchange(other.m_oneshot, nullptr))
+    {
+    }
+
+    OneshotSender& operator=(OneshotSender&&) = delete;
+    OneshotSender(const OneshotSender&) = delete;
+    OneshotSender& operator=(const OneshotSender&) = delete;
+
+    ~OneshotSender()
+    {
+        if (m_oneshot != nullptr)
+        {
+            close(0);
+        }
+    }
+
+    //! Send @p value to the receiver, and wake it if it's waiting
+    //!
+    //! @returns false if the receiver has already been dropped, in which case @p value is dropped
+    //! @throws std::logic_error if this sender has already sent a value.
+    bool send(ValueT value) noexcept(false)
+    {
+        if (m_oneshot == nullptr)
+        {
+            throw std::logic_error("Oneshot value already sent");
+        }
+        if (is_receiver_dropped())
+        {
+            close(0);
+            return false;
+        }
+        ::new (static_cast<void*>(&m_oneshot->m_value)) ValueT(std::move(value));
+        return close(Oneshot<ValueT>::value_sent);
+    }
+
+    //! Indicates whether the receiver has been dropped, so there's no point sending a value
+    [[nodiscard]] bool is_receiver_dropped() const noexcept
+    {
+        return m_oneshot == nullptr ||
+               (m_oneshot->m_state.load(std::memory_order_relaxed) &
+                Oneshot<ValueT>::receiver_dropped) != 0;
+    }
+
+  private:
+    using OneshotT = Oneshot<ValueT>;
+
+    //! Close the channel, wake the receiver if it's waiting, and drop the sender
+    //!
+    //! @returns false if the receiver had already been dropped
+    bool close(std::uint32_t sent) noexcept
+    {
+        OneshotT* oneshot = std::exchange(m_oneshot, nullptr);
+        std::uint32_t state = oneshot->m_state.load(std::memory_order_relaxed);
+        std::uint32_t desired = 0;
+        do
+        {
+            // A waiting receiver could free the state as soon as it sees the sender dropped, so
+            // wake it before saying so
+            desired = state | sent | OneshotT::sender_closed;
+            if ((state & OneshotT::receiver_waiting) == 0)
+            {
+                desired |= OneshotT::sender_dropped;
+            }
+        } while (!oneshot->m_state.compare_exchange_weak(
+            state, desired, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        const bool received = (state & OneshotT::receiver_dropped) == 0;
+        if ((desired & OneshotT::sender_dropped) != 0)
+        {
+            if (!received && oneshot->m_owned)
+            {
+                delete oneshot;
+            }
+            return received;
+        }
+
+        detail::futex_wake(oneshot->m_state, 1);
+        oneshot->drop(OneshotT::sender_dropped, OneshotT::receiver_dropped);
+        return received;
+    }
+
+    OneshotT* m_oneshot;
+};
+
+//! The receiving half of a Oneshot
+template<typename ValueT>
+class OneshotReceiver
+{
+  public:
+    explicit OneshotReceiver(Oneshot<ValueT>& oneshot) noexcept : m_oneshot(&oneshot) {}
+
+    OneshotReceiver(OneshotReceiver&& other) noexcept :
+        m_oneshot(std::exchange(other.m_oneshot, nullptr))
+    {
+    }
+
+    OneshotReceiver& operator=(OneshotReceiver&&) = delete;
+    OneshotReceiver(const OneshotReceiver&) = delete;
+    OneshotReceiver& operator=(const OneshotReceiver&) = delete;
+
+    ~OneshotReceiver()
+    {
+        if (m_oneshot != nullptr)
+        {
+            m_oneshot->drop(OneshotT::receiver_dropped, OneshotT::sender_dropped);
+        }
+    }
+
+    //! Wait for the value, and return it
+    //!
+    //! @throws std::runtime_error if the sender was dropped without sending a value.
+    //! @throws std::logic_error if the value has already been received.
+    [[nodiscard]] ValueT recv() noexcept(false)
+    {
+        auto sleep = [](const std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+            detail::futex_wait(word, expected);
+        };
+        std::uint32_t state = load();
+        while ((state & OneshotT::sender_closed) == 0)
+        {
+            state = wait(state, sleep);
+        }
+        return take(state);
+    }
+
+    //! Wait up to @p timeout for the value, and return it
+    //!
+    //! @returns the value, or an empty optional if the timeout elapsed first
+    //! @throws std::runtime_error if the sender was dropped without sending a value.
+    //! @throws std::logic_error if the value has already been received.
+    template<typename RepT, typename PeriodT>
+    [[nodiscard]] std::optional<ValueT>
+    recv_for(const std::chrono::duration<RepT, PeriodT>& timeout) noexcept(false)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::uint32_t state = load();
+        while ((state & OneshotT::sender_closed) == 0)
+        {
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now());
+            bool timed_out = false;
+            auto sleep = [&](const std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+                timed_out = !detail::futex_wait_for(word, expected, remaining);
+            };
+            state = wait(state, sleep);
+            if (timed_out && (state & OneshotT::sender_closed) == 0)
+            {
+                return std::nullopt;
+            }
+        }
+        return take(state);
+    }
+
+    //! Return the value if it's been sent, without waiting
+    //!
+    //! @throws std::runtime_error if the sender was dropped without sending a value.
+    //! @throws std::logic_error if the value has already been received.
+    [[nodiscard]] std::optional<ValueT> try_recv() noexcept(false)
+    {
+        const std::uint32_t state = load();
+        if ((state & OneshotT::sender_closed) == 0)
+        {
+            return std::nullopt;
+        }
+        return take(state);
+    }
+
+    //! Indicates whether the sender was dropped without sending a value
+    [[nodiscard]] bool is_sender_dropped() const noexcept
+    {
+        if (m_oneshot == nullptr)
+        {
+            return false;
+        }
+        const std::uint32_t state = m_oneshot->m_state.load(std::memory_order_relaxed);
+        return (state & OneshotT::sender_closed) != 0 && (state & OneshotT::value_sent) == 0;
+    }
+
+  private:
+    using OneshotT = Oneshot<ValueT>;
+
+    std::uint32_t load() const noexcept(false)
+    {
+        if (m_oneshot == nullptr)
+        {
+            throw std::logic_error("Oneshot value already received");
+        }
+        return m_oneshot->m_state.load(std::memory_order_acquire);
+    }
+
+    //! Mark the receiver as waiting, and sleep with @p sleep until the state changes
+    //!
+    //! @returns the new state
+    template<typename SleepT>
+    std::uint32_t wait(std::uint32_t state, SleepT&& sleep) noexcept
+    {
+        std::atomic<std::uint32_t>& word = m_oneshot->m_state;
+        if ((state & OneshotT::receiver_waiting) == 0)
+        {
+            const std::uint32_t waiting = state | OneshotT::receiver_waiting;
+            if (!word.compare_exchange_strong(
+                    state, waiting, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return state;
+            }
+            state = waiting;
+        }
+        sleep(word, state);
+        return word.load(std::memory_order_acquire);
+    }
+
+    ValueT take(std::uint32_t state) noexcept(false)
+    {
+        if ((state & OneshotT::value_sent) == 0)
+        {
+            throw std::runtime_error("Oneshot sender dropped without sending a value");
+        }
+
+        ValueT value(std::move(m_oneshot->m_value));
+        m_oneshot->m_value.~ValueT();
+        std::exchange(m_oneshot, nullptr)
+            ->drop(OneshotT::receiver_dropped | OneshotT::value_taken, OneshotT::sender_dropped);
+        return value;
+    }
+
+    OneshotT* m_oneshot;
+};
+
+}  // namespace rmx
@@ -0,0 +1,188 @@
+#pragma once
+#include <rmx/semaphore.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace rmx {
+
+template<typename ValueT>
+class Pool;
+
+//! An RAII-style guard wrapping a reference to an object checked out of a Pool
+//!
+//! The object is returned to the Pool when the guard goes out of scope.
+//!
+//! Acquire a `PoolGuard` by calling `Pool::acquire()`.
+template<typename ValueT>
+class PoolGuard
+{
+  public:
+    explicit PoolGuard(Pool<ValueT>& pool, std::uint32_t index) noexcept :
+        m_pool(&pool), m_index(index)
+    {
+    }
+
+    PoolGuard(PoolGuard&& other) noexcept :
+        m_pool(std::exchange(other.m_pool, nullptr)), m_index(other.m_index)
+    {
+    }
+
+    PoolGuard& operator=(PoolGuard&&) = delete;
+    PoolGuard(const PoolGuard&) = delete;
+    PoolGuard& operator=(const PoolGuard&) = delete;
+
+    ~PoolGuard()
+    {
+        if (m_pool != nullptr)
+        {
+            m_pool->release(m_index);
+        }
+    }
+
+    //! Access the checked out object by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] ValueT& operator*() noexcept { return m_pool->m_objects[m_index]; }
+    [[nodiscard]] const ValueT& operator*() const noexcept { return m_pool->m_objects[m_index]; }
+
+    //! Access the checked out object by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] ValueT* operator->() noexcept { return &**this; }
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &**this; }
+
+  private:
+    Pool<ValueT>* m_pool;
+    std::uint32_t m_index;
+};
+
+//! A fixed set of objects, like connections, that threads check out one at a time
+//!
+//! A Semaphore counts the free objects, so callers sleep only when every object is checked out. The
+//! free objects themselves are kept on a lock-free stack, so checking objects out and back in
+//! doesn't serialize on a mutex.
+//!
+//! @code
+//! rmx::Pool<Connection> connections(std::move(opened));
+//! auto connection = connections.acquire();
+//! connection->query(sql);
+//! @endcode
+template<typename ValueT>
+class Pool
+{
+  public:
+    //! Take ownership of @p objects
+    //!
+    //! @throws std::length_error if there are too many objects to index.
+    explicit Pool(std::vector<ValueT> objects) noexcept(false) :
+        m_objects(std::move(objects)),
+        m_next(std::make_unique<std::atomic<std::uint32_t>[]>(m_objects.size()))
+    {
+        if (m_objects.size() >= std::numeric_limits<std::uint32_t>::max())
+        {
+            throw std::length_error("Too many objects for a Pool");
+        }
+        for (std::size_t i = 0; i < m_objects.size(); i++)
+        {
+            push(static_cast<std::uint32_t>(i));
+        }
+        m_free.release(static_cast<std::uint32_t>(m_objects.size()));
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    //! Check out a free object, waiting for one to be returned if necessary
+    [[nodiscard]] PoolGuard<ValueT> acquire() noexcept
+    {
+        m_free.acquire();
+        return PoolGuard<ValueT>(*this, pop());
+    }
+
+    //! Check out a free object, unless they're all checked out
+    [[nodiscard]] std::optional<PoolGuard<ValueT>> try_acquire() noexcept
+    {
+        if (!m_free.try_acquire())
+        {
+            return std::nullopt;
+        }
+        return std::optional<PoolGuard<ValueT>>(std::in_place, *this, pop());
+    }
+
+    //! Check out a free object, waiting up to @p timeout for one to be returned if necessary
+    template<typename RepT, typename PeriodT>
+    [[nodiscard]] std::optional<PoolGuard<ValueT>>
+    try_acquire_for(const std::chrono::duration<RepT, PeriodT>& timeout) noexcept
+    {
+        if (!m_free.try_acquire_for(timeout))
+        {
+            return std::nullopt;
+        }
+        return std::optional<PoolGuard<ValueT>>(std::in_place, *this, pop());
+    }
+
+    //! The number of objects in the Pool
+    [[nodiscard]] std::size_t size() const noexcept { return m_objects.size(); }
+
+    //! The number of objects that aren't checked out right now
+    [[nodiscard]] std::size_t available() const noexcept { return m_free.available(); }
+
+  private:
+    friend PoolGuard<ValueT>;
+
+    //! The head of the free stack packs a generation count, which defeats ABA, above the index of
+    //! the top object plus one, which is zero when the stack is empty
+    static constexpr std::uint64_t index_mask = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint64_t generation = index_mask + 1;
+
+    void release(std::uint32_t index) noexcept
+    {
+        push(index);
+        m_free.release();
+    }
+
+    void push(std::uint32_t index) noexcept
+    {
+        std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        std::uint64_t desired = 0;
+        do
+        {
+            m_next[index].store(static_cast<std::uint32_t>(head & index_mask),
+                                std::memory_order_relaxed);
+            desired = ((head & ~index_mask) + generation) | (index + 1);
+        } while (!m_head.compare_exchange_weak(
+            head, desired, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    //! Pop a free object's index, which must exist because the caller holds a permit for it
+    std::uint32_t pop() noexcept
+    {
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        std::uint64_t desired = 0;
+        do
+        {
+            const std::uint64_t top = head & index_mask;
+            const std::uint32_t next = m_next[top - 1].load(std::memory_order_relaxed);
+            desired = ((head & ~index_mask) + generation) | next;
+        } while (!m_head.compare_exchange_weak(
+            head, desired, std::memory_order_acquire, std::memory_order_acquire));
+        return static_cast<std::uint32_t>((head & index_mask) - 1);
+    }
+
+    std::vector<ValueT> m_objects;
+    //! For each free object, the index plus one of the object below it on the free stack
+    std::unique_ptr<std::atomic<std::uint32_t>[]> m_next;
+    std::atomic<std::uint64_t> m_head{0};
+    Semaphore m_free;
+};
+
+}  // namespace rmx
@@ -0,0 +1,369 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! A process-shared reader/writer lock, for a Mutex placed in shared memory
+//!
+//! A ProcessRwMutex is SharedLockable, so locking a `const rmx::Mutex<ValueT, ProcessRwMutex>`
+//! takes a shared lock that never blocks other readers. It consists only of futex words, so it's
+//! position independent, and can be placed in a memory segment shared with `mmap(MAP_SHARED)`.
+//! Waiting writers take priority over new readers.
+//!
+//! @warning Unlike a RobustMutex, a ProcessRwMutex can't detect that a process died while holding
+//! it.
+class ProcessRwMutex
+{
+  public:
+    ProcessRwMutex() noexcept = default;
+    ~ProcessRwMutex() = default;
+
+    ProcessRwMutex(const ProcessRwMutex&) = delete;
+    ProcessRwMutex& operator=(const ProcessRwMutex&) = delete;
+    ProcessRwMutex(ProcessRwMutex&&) = delete;
+    ProcessRwMutex& operator=(ProcessRwMutex&&) = delete;
+
+    void lock() noexcept
+    {
+        if (try_lock())
+        {
+            return;
+        }
+
+        m_writers_waiting.fetch_add(1, std::memory_order_seq_cst);
+        for (;;)
+        {
+            std::uint32_t state = m_state.load(std::memory_order_relaxed);
+            if (state == 0 &&
+                m_state.compare_exchange_weak(
+                    state, writer_bit, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                break;
+            }
+            if (state != 0)
+            {
+                sleep(state);
+            }
+        }
+        m_writers_waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        std::uint32_t expected = 0;
+        return m_state.compare_exchange_strong(
+            expected, writer_bit, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        m_state.store(0, std::memory_order_seq_cst);
+        wake_sleepers();
+    }
+
+    void lock_shared() noexcept
+    {
+        for (;;)
+        {
+            std::uint32_t state = m_state.load(std::memory_order_relaxed);
+            if (can_read(state))
+            {
+                if (m_state.compare_exchange_weak(
+                        state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    return;
+                }
+                continue;
+            }
+            sleep(state);
+        }
+    }
+
+    [[nodiscard]] bool try_lock_shared() noexcept
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (can_read(state))
+        {
+            if (m_state.compare_exchange_weak(
+                    state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void unlock_shared() noexcept
+    {
+        if (m_state.fetch_sub(1, std::memory_order_seq_cst) == 1)
+        {
+            wake_sleepers();
+        }
+    }
+
+  private:
+    static constexpr std::uint32_t writer_bit = 1U << 31U;
+
+    //! The number of readers holding the lock, or writer_bit if a writer holds it
+    std::atomic<std::uint32_t> m_state{0};
+    std::atomic<std::uint32_t> m_writers_waiting{0};
+    std::atomic<std::uint32_t> m_sleepers{0};
+
+    [[nodiscard]] bool can_read(std::uint32_t state) const noexcept
+    {
+        return (state & writer_bit) == 0 && m_writers_waiting.load(std::memory_order_relaxed) == 0;
+    }
+
+    void sleep(std::uint32_t state) noexcept
+    {
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        detail::futex_wait(m_state, state, detail::FutexScope::Shared);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wake_sleepers() noexcept
+    {
+        if (m_sleepers.load(std::memory_order_seq_cst) != 0)
+        {
+            detail::futex_wake_all(m_state, detail::FutexScope::Shared);
+        }
+    }
+};
+
+template<typename ValueT>
+class ProcessSeqLock;
+
+//! An RAII-style guard that writes a new value into a ProcessSeqLock
+//!
+//! The guard mutates a private copy of the value, which is published to readers when the guard goes
+//! out of scope. If it goes out of scope because of an exception, the copy is discarded instead, so
+//! readers never observe a partially applied write.
+//!
+//! Acquire a `SeqLockWriteGuard` by calling `ProcessSeqLock::write()`.
+template<typename ValueT>
+class SeqLockWriteGuard
+{
+  public:
+    explicit SeqLockWriteGuard(ProcessSeqLock<ValueT>& lock, ValueT value) noexcept :
+        m_lock(&lock), m_value(value), m_exceptions(std::uncaught_exceptions())
+    {
+    }
+
+    SeqLockWriteGuard(SeqLockWriteGuard&& other) noexcept :
+        m_lock(std::exchange(other.m_lock, nullptr)),
+        m_value(other.m_value),
+        m_exceptions(other.m_exceptions)
+    {
+    }
+    SeqLockWriteGuard& operator=(SeqLockWriteGuard&&) = delete;
+
+    SeqLockWriteGuard(const SeqLockWriteGuard&) = delete;
+    SeqLockWriteGuard& operator=(const SeqLockWriteGuard&) = delete;
+
+    ~SeqLockWriteGuard()
+    {
+        if (m_lock != nullptr)
+        {
+            const bool commit = std::uncaught_exceptions() <= m_exceptions;
+            m_lock->unlock(commit ? &m_value : nullptr);
+        }
+    }
+
+    //! Access the value to be written by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] ValueT& operator*() noexcept { return m_value; }
+    [[nodiscard]] const ValueT& operator*() const noexcept { return m_value; }
+
+    //! Access the value to be written by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] ValueT* operator->() noexcept { return &m_value; }
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &m_value; }
+
+  private:
+    ProcessSeqLock<ValueT>* m_lock;
+    ValueT m_value;
+    int m_exceptions;
+};
+
+//! A process-shared sequence lock, for read-mostly values placed in shared memory
+//!
+//! Readers never block each other, or writers. Instead, they copy the value out, and retry if a
+//! writer modified it while they were copying. This makes it ideal for small values that are read
+//! far more often than they're written. Writers are serialized with a futex.
+//!
+//! A ProcessSeqLock consists only of atomic words, so it's position independent, and can be placed
+//! in a memory segment shared with `mmap(MAP_SHARED)`.
+//!
+//! @note @p ValueT must be trivially copyable, since readers may copy it while it's being written.
+template<typename ValueT>
+class ProcessSeqLock
+{
+    static_assert(std::is_trivially_copyable_v<ValueT>, "ValueT must be trivially copyable");
+    static_assert(std::is_default_constructible_v<ValueT>, "ValueT must be default constructible");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "ProcessSeqLock requires lock free 64-bit atomics");
+
+  public:
+    explicit ProcessSeqLock(const ValueT& value = ValueT{}) noexcept { store_words(value); }
+
+    ProcessSeqLock(const ProcessSeqLock&) = delete;
+    ProcessSeqLock& operator=(const ProcessSeqLock&) = delete;
+    ProcessSeqLock(ProcessSeqLock&&) = delete;
+    ProcessSeqLock& operator=(ProcessSeqLock&&) = delete;
+    ~ProcessSeqLock() = default;
+
+    //! Read a consistent copy of the value, retrying while it's being written
+    [[nodiscard]] ValueT read() const noexcept
+    {
+        for (;;)
+        {
+            if (auto value = try_read(); value.has_value())
+            {
+                return *value;
+            }
+            detail::cpu_relax();
+        }
+    }
+
+    //! Attempt to read a consistent copy of the value, failing if it's being written
+    [[nodiscard]] std::optional<ValueT> try_read() const noexcept
+    {
+        const std::uint32_t before = m_sequence.load(std::memory_order_acquire);
+        if ((before & 1U) != 0)
+        {
+            return std::nullopt;
+        }
+
+        std::array<std::uint64_t, word_count> words{};
+        for (std::size_t i = 0; i < word_count; i++)
+        {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (m_sequence.load(std::memory_order_relaxed) != before)
+        {
+            return std::nullopt;
+        }
+        ValueT value;
+        std::memcpy(&value, words.data(), sizeof(ValueT));
+        return value;
+    }
+
+    //! Lock out other writers, and return an RAII guard that publishes a new value
+    [[nodiscard]] SeqLockWriteGuard<ValueT> write() noexcept
+    {
+        lock();
+        return SeqLockWriteGuard<ValueT>(*this, load_words());
+    }
+
+    //! Attempt to lock out other writers, and return an RAII guard that publishes a new value
+    [[nodiscard]] std::optional<SeqLockWriteGuard<ValueT>> try_write() noexcept
+    {
+        if (!try_lock())
+        {
+            return std::nullopt;
+        }
+        return std::optional<SeqLockWriteGuard<ValueT>>(std::in_place, *this, load_words());
+    }
+
+    //! Publish a new value
+    void store(const ValueT& value) noexcept
+    {
+        lock();
+        unlock(&value);
+    }
+
+  private:
+    friend class SeqLockWriteGuard<ValueT>;
+
+    static constexpr std::size_t word_count =
+        (sizeof(ValueT) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    //! Even when the value is stable, and odd while a writer holds the lock
+    std::atomic<std::uint32_t> m_sequence{0};
+    std::atomic<std::uint32_t> m_writers_waiting{0};
+    std::array<std::atomic<std::uint64_t>, word_count> m_words{};
+
+    void lock() noexcept
+    {
+        for (;;)
+        {
+            if (try_lock())
+            {
+                return;
+            }
+            const std::uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+            if ((sequence & 1U) != 0)
+            {
+                m_writers_waiting.fetch_add(1, std::memory_order_seq_cst);
+                detail::futex_wait(m_sequence, sequence, detail::FutexScope::Shared);
+                m_writers_waiting.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] bool try_lock() noexcept
+    {
+        std::uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1U) != 0 ||
+            !m_sequence.compare_exchange_strong(
+                sequence, sequence + 1, std::memory_order_relaxed, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        // Order the odd sequence number before any writes to the value
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    //! Publish @p value, if any, and release the writer lock
+    void unlock(const ValueT* value) noexcept
+    {
+        if (value != nullptr)
+        {
+            store_words(*value);
+        }
+        m_sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (m_writers_waiting.load(std::memory_order_seq_cst) != 0)
+        {
+            detail::futex_wake(m_sequence, 1, detail::FutexScope::Shared);
+        }
+    }
+
+    [[nodiscard]] ValueT load_words() const noexcept
+    {
+        std::array<std::uint64_t, word_count> words{};
+        for (std::size_t i = 0; i < word_count; i++)
+        {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        ValueT value;
+        std::memcpy(&value, words.data(), sizeof(ValueT));
+        return value;
+    }
+
+    void store_words(const ValueT& value) noexcept
+    {
+        std::array<std::uint64_t, word_count> words{};
+        std::memcpy(words.data(), &value, sizeof(ValueT));
+        for (std::size_t i = 0; i < word_count; i++)
+        {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+};
+
+}  // namespace rmx
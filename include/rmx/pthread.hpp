@@ -0,0 +1,198 @@
+#pragma once
+#include <pthread.h>
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+namespace rmx::detail {
+inline void throw_if_error(int err, const char* what) noexcept(false)
+{
+    if (err != 0)
+    {
+        throw std::system_error(err, std::system_category(), what);
+    }
+}
+
+//! An RAII wrapper around pthread_mutexattr_t
+class PthreadMutexAttr
+{
+  public:
+    PthreadMutexAttr() noexcept(false)
+    {
+        throw_if_error(pthread_mutexattr_init(&m_attr), "pthread_mutexattr_init");
+    }
+    ~PthreadMutexAttr() { pthread_mutexattr_destroy(&m_attr); }
+
+    PthreadMutexAttr(const PthreadMutexAttr&) = delete;
+    PthreadMutexAttr& operator=(const PthreadMutexAttr&) = delete;
+    PthreadMutexAttr(PthreadMutexAttr&&) = delete;
+    PthreadMutexAttr& operator=(PthreadMutexAttr&&) = delete;
+
+    [[nodiscard]] pthread_mutexattr_t* get() noexcept { return &m_attr; }
+    [[nodiscard]] const pthread_mutexattr_t* get() const noexcept { return &m_attr; }
+
+  private:
+    pthread_mutexattr_t m_attr{};
+};
+
+//! A Lockable pthread_mutex_t, configured by its derived class
+class PthreadMutex
+{
+  public:
+    ~PthreadMutex() { pthread_mutex_destroy(&m_mutex); }
+
+    PthreadMutex(const PthreadMutex&) = delete;
+    PthreadMutex& operator=(const PthreadMutex&) = delete;
+    PthreadMutex(PthreadMutex&&) = delete;
+    PthreadMutex& operator=(PthreadMutex&&) = delete;
+
+    void lock() noexcept(false)
+    {
+        throw_if_error(pthread_mutex_lock(&m_mutex), "pthread_mutex_lock");
+    }
+
+    [[nodiscard]] bool try_lock() noexcept(false)
+    {
+        const int err = pthread_mutex_trylock(&m_mutex);
+        if (err == EBUSY)
+        {
+            return false;
+        }
+        throw_if_error(err, "pthread_mutex_trylock");
+        return true;
+    }
+
+    void unlock() noexcept { pthread_mutex_unlock(&m_mutex); }
+
+    [[nodiscard]] pthread_mutex_t* native_handle() noexcept { return &m_mutex; }
+
+  protected:
+    //! Initialize the mutex with attributes set by @p configure(pthread_mutexattr_t*)
+    template<typename ConfigureT>
+    explicit PthreadMutex(ConfigureT&& configure) noexcept(false)
+    {
+        PthreadMutexAttr attr;
+        std::forward<ConfigureT>(configure)(attr.get());
+        throw_if_error(pthread_mutex_init(&m_mutex, attr.get()), "pthread_mutex_init");
+    }
+
+    pthread_mutex_t m_mutex{};
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A priority-inheritance mutex, for sharing state between realtime and normal-priority threads
+//!
+//! While a thread holds a PiMutex, it inherits the priority of the highest priority thread blocked
+//! on it. This bounds the time that a SCHED_FIFO thread can be blocked by a lower priority holder,
+//! because medium priority threads can't preempt the holder.
+//!
+//! @code
+//! rmx::Mutex<State, rmx::PiMutex> mutex;
+//! @endcode
+class PiMutex : public detail::PthreadMutex
+{
+  public:
+    PiMutex() noexcept(false) : PthreadMutex(configure) {}
+
+  private:
+    static void configure(pthread_mutexattr_t* attr) noexcept(false)
+    {
+        detail::throw_if_error(pthread_mutexattr_setprotocol(attr, PTHREAD_PRIO_INHERIT),
+                               "pthread_mutexattr_setprotocol");
+    }
+};
+
+//! A priority-ceiling mutex, for sharing state between realtime and normal-priority threads
+//!
+//! While a thread holds a CeilingMutex, it runs at (at least) the @p v_Ceiling priority. Unlike a
+//! PiMutex, the holder's priority is raised as soon as it acquires the lock, rather than when a
+//! higher priority thread blocks on it.
+//!
+//! @note Only realtime (SCHED_FIFO or SCHED_RR) threads with a priority no higher than
+//! @p v_Ceiling may lock a CeilingMutex. Otherwise locking throws a std::system_error (EINVAL).
+template<int v_Ceiling>
+class CeilingMutex : public detail::PthreadMutex
+{
+  public:
+    CeilingMutex() noexcept(false) : PthreadMutex(configure) {}
+
+    [[nodiscard]] static constexpr int priority_ceiling() noexcept { return v_Ceiling; }
+
+  private:
+    static void configure(pthread_mutexattr_t* attr) noexcept(false)
+    {
+        detail::throw_if_error(pthread_mutexattr_setprotocol(attr, PTHREAD_PRIO_PROTECT),
+                               "pthread_mutexattr_setprotocol");
+        detail::throw_if_error(pthread_mutexattr_setprioceiling(attr, v_Ceiling),
+                               "pthread_mutexattr_setprioceiling");
+    }
+};
+
+//! A process-shared robust mutex, for a Mutex placed in shared memory
+//!
+//! If the thread or process holding a RobustMutex dies, the next thread to lock it takes ownership,
+//! and the wrapping Mutex is poisoned, exactly as if an exception was thrown while it was locked.
+//!
+//! The whole `rmx::Mutex<ValueT, rmx::RobustMutex>` can be placed in a memory segment shared with
+//! `mmap(MAP_SHARED)`, provided that @p ValueT itself is position independent (it contains no
+//! pointers). Construct it once with placement new, and have the other processes access it through
+//! a pointer into their own mapping of the segment.
+//!
+//! @code
+//! void* segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+//! auto* mutex = new (segment) rmx::Mutex<Counters, rmx::RobustMutex>();
+//! @endcode
+//!
+//! @warning Exactly one process should run the destructor, after all others are done with it.
+class RobustMutex : public detail::PthreadMutex
+{
+  public:
+    RobustMutex() noexcept(false) : PthreadMutex(configure) {}
+
+    void lock() noexcept(false) { on_locked(pthread_mutex_lock(&m_mutex), "pthread_mutex_lock"); }
+
+    [[nodiscard]] bool try_lock() noexcept(false)
+    {
+        const int err = pthread_mutex_trylock(&m_mutex);
+        if (err == EBUSY)
+        {
+            return false;
+        }
+        on_locked(err, "pthread_mutex_trylock");
+        return true;
+    }
+
+    //! Indicates whether the previous owner died while holding the lock, and resets the indicator
+    //!
+    //! @note Only the current owner of the lock may call this method.
+    [[nodiscard]] bool take_owner_died() noexcept { return std::exchange(m_owner_died, false); }
+
+  private:
+    bool m_owner_died = false;
+
+    static void configure(pthread_mutexattr_t* attr) noexcept(false)
+    {
+        detail::throw_if_error(pthread_mutexattr_setpshared(attr, PTHREAD_PROCESS_SHARED),
+                               "pthread_mutexattr_setpshared");
+        detail::throw_if_error(pthread_mutexattr_setrobust(attr, PTHREAD_MUTEX_ROBUST),
+                               "pthread_mutexattr_setrobust");
+    }
+
+    void on_locked(int err, const char* what) noexcept(false)
+    {
+        if (err == EOWNERDEAD)
+        {
+            // The lock is ours, but we need to mark it consistent, or it'll be unusable after
+            // we unlock it. Whether the data it protects is consistent is for rmx to decide.
+            pthread_mutex_consistent(&m_mutex);
+            m_owner_died = true;
+            return;
+        }
+        detail::throw_if_error(err, what);
+    }
+};
+
+}  // namespace rmx
@@ -0,0 +1,189 @@
+#pragma once
+#include <rmx/detail/thread_slot.hpp>
+#include <rmx/rmx.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! A set of interchangeable copies of a value, where locking takes whichever copy is free
+//!
+//! Use this for scratch state that any thread can use, but only one at a time, like compression
+//! contexts or parse buffers. Rather than queueing on a single Mutex, lock() first tries the
+//! replica this thread used last, then any other free replica, and only blocks when all of them are
+//! busy. Each replica is a CachePadded Mutex, so replicas in use on different threads don't falsely
+//! share cache lines.
+//!
+//! Poisoned replicas are skipped, so an exception thrown while one replica is locked only takes
+//! that replica out of service.
+//!
+//! @code
+//! rmx::ReplicaPool<Compressor, 8> compressors(level);
+//! compressors.lock()->compress(input, output);
+//! @endcode
+template<typename ValueT, std::size_t v_Replicas, typename MutexImplT = std::mutex>
+class ReplicaPool
+{
+    static_assert(v_Replicas > 0, "A ReplicaPool needs at least one replica");
+
+  public:
+    using Replica = Mutex<ValueT, MutexImplT, CachePadded>;
+
+    //! Construct every replica from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, const ArgsT&...>, bool> =
+                 true>
+    explicit ReplicaPool(const ArgsT&... args) :
+        ReplicaPool(std::make_index_sequence<v_Replicas>(), args...)
+    {
+    }
+
+    ReplicaPool(const ReplicaPool&) = delete;
+    ReplicaPool& operator=(const ReplicaPool&) = delete;
+
+    //! Lock a free, unpoisoned replica, waiting for one if they're all busy
+    //!
+    //! @throws std::runtime_error if every replica has been poisoned.
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock() noexcept(false)
+    {
+        if (auto guard = try_lock())
+        {
+            return MutexGuard<ValueT, MutexImplT>(std::move(*guard));
+        }
+
+        // Every replica is busy, so wait for the one this thread last used, which spreads the
+        // waiting threads over the replicas
+        for (std::size_t i = 0; i < v_Replicas; i++)
+        {
+            const std::size_t index = (last_used() + i) % v_Replicas;
+            Replica& replica = m_replicas[index];
+            if (replica.is_poisoned())
+            {
+                continue;
+            }
+            auto guard = replica.lock_unchecked();
+            if (!replica.is_poisoned())
+            {
+                last_used() = index;
+                return MutexGuard<ValueT, MutexImplT>(std::move(guard));
+            }
+        }
+        throw_all_poisoned();
+    }
+
+    //! Lock any replica, without waiting or checking for poison, unless they're all busy, in which
+    //! case wait for the one this thread last used
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock_unchecked() noexcept
+    {
+        for (std::size_t i = 0; i < v_Replicas; i++)
+        {
+            const std::size_t index = (last_used() + i) % v_Replicas;
+            if (auto guard = m_replicas[index].try_lock_unchecked())
+            {
+                last_used() = index;
+                return MutexGuard<ValueT, MutexImplT>(std::move(*guard));
+            }
+        }
+        return m_replicas[last_used()].lock_unchecked();
+    }
+
+    //! Lock a free, unpoisoned replica, unless they're all busy
+    //!
+    //! @throws std::runtime_error if every replica has been poisoned.
+    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT>> try_lock() noexcept(false)
+    {
+        bool all_poisoned = true;
+        for (std::size_t i = 0; i < v_Replicas; i++)
+        {
+            const std::size_t index = (last_used() + i) % v_Replicas;
+            Replica& replica = m_replicas[index];
+            if (replica.is_poisoned())
+            {
+                continue;
+            }
+            all_poisoned = false;
+
+            auto guard = replica.try_lock_unchecked();
+            // The replica may have been poisoned after the check above, but before it was locked
+            if (guard && !replica.is_poisoned())
+            {
+                last_used() = index;
+                return guard;
+            }
+        }
+        if (all_poisoned)
+        {
+            throw_all_poisoned();
+        }
+        return std::nullopt;
+    }
+
+    //! Lock a free replica, and invoke @p function on it
+    //!
+    //! @returns the result of @p function
+    //! @throws std::runtime_error if every replica has been poisoned. If @p function throws, the
+    //! exception propagates, and poisons the replica it was invoked on.
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with(FunctionT&& function) noexcept(false)
+    {
+        auto guard = lock();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! The number of replicas
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return v_Replicas; }
+
+    //! The number of replicas that have been poisoned, and are out of service
+    [[nodiscard]] std::size_t poisoned() const noexcept
+    {
+        std::size_t count = 0;
+        for (const Replica& replica : m_replicas)
+        {
+            count += replica.is_poisoned() ? 1 : 0;
+        }
+        return count;
+    }
+
+    //! Clear the poisoned state of every replica, putting them all back in service
+    //!
+    //! Each replica is locked while its poison is cleared, so this waits for any guard on it to be
+    //! released, and mustn't be called while holding one.
+    void clear_poison() noexcept
+    {
+        for (Replica& replica : m_replicas)
+        {
+            auto guard = replica.lock_unchecked();
+            replica.clear_poison();
+        }
+    }
+
+  private:
+    template<std::size_t... v_Indices, typename... ArgsT>
+    explicit ReplicaPool(std::index_sequence<v_Indices...> /*unused*/, const ArgsT&... args) :
+        m_replicas{{(static_cast<void>(v_Indices), Replica(args...))...}}
+    {
+    }
+
+    //! The replica the calling thread locked last, shared by every ReplicaPool of this type
+    static std::size_t& last_used() noexcept
+    {
+        thread_local std::size_t index = detail::thread_slot() % v_Replicas;
+        return index;
+    }
+
+    [[noreturn]] static void throw_all_poisoned() noexcept(false)
+    {
+        throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+    }
+
+    std::array<Replica, v_Replicas> m_replicas;
+};
+
+}  // namespace rmx
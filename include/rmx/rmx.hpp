@@ -1,25 +1,188 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <functional>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#ifndef RMX_CACHE_LINE_SIZE
+    //! The assumed size of a cache line, in bytes
+    //!
+    //! Override this for platforms with larger cache lines, or where adjacent lines are prefetched
+    //! in pairs.
+    #define RMX_CACHE_LINE_SIZE 64
+#endif
+
+namespace rmx {
+
+//! The minimum offset between two objects to avoid false sharing
+//!
+//! This stands in for std::hardware_destructive_interference_size, which compilers may change
+//! between versions or tuning flags, and is therefore unsafe to use in the layout of a header-only
+//! library's types (GCC warns about exactly this with -Winterference-size).
+inline constexpr std::size_t hardware_destructive_interference_size = RMX_CACHE_LINE_SIZE;
+
+//! Mutex layout policy that stores the lock, value, and poison flag contiguously, with no padding
+//!
+//! This is the most compact layout, but adjacent Mutexes may falsely share cache lines.
+struct Compact
+{
+};
+
+//! Mutex layout policy that aligns and pads the whole Mutex to a cache line
+//!
+//! Use this for arrays of Mutexes, so that locking one doesn't invalidate its neighbors.
+struct CachePadded
+{
+};
+
+//! Mutex layout policy that places the lock, poison flag, and a small value on the same cache line
+//!
+//! Acquiring the lock brings the value into cache along with it. The whole Mutex must fit in a
+//! single cache line.
+struct Colocated
+{
+};
+
+//! Mutex layout policy that places the lock and poison flag on one cache line, and the value on
+//! another
+//!
+//! Use this when threads contending for the lock would otherwise slow down the lock holder's
+//! access to the value.
+struct Split
+{
+};
+
+//! Mutex versioning policy that doesn't track changes to the value
+struct Unversioned
+{
+};
+
+//! Mutex versioning policy that counts releases of mutable guards, so that callers can tell
+//! whether the value may have changed without locking it
+//!
+//! See Mutex::version().
+struct Versioned
+{
+};
+
+}  // namespace rmx
+
+namespace rmx::detail {
+//! Detects whether @p MutexImplT satisfies the SharedLockable named requirement
+template<typename MutexImplT, typename = void>
+struct IsSharedLockable : std::false_type
+{
+};
+
+template<typename MutexImplT>
+struct IsSharedLockable<MutexImplT,
+                        std::void_t<decltype(std::declval<MutexImplT&>().lock_shared()),
+                                    decltype(std::declval<MutexImplT&>().try_lock_shared()),
+                                    decltype(std::declval<MutexImplT&>().unlock_shared())>> :
+    std::true_type
+{
+};
+
+template<typename MutexImplT>
+inline constexpr bool is_shared_lockable_v = IsSharedLockable<MutexImplT>::value;
+
+//! Detects whether @p MutexImplT is a robust mutex that reports when its previous owner died
+//! while holding it, through a `bool take_owner_died()` method
+template<typename MutexImplT, typename = void>
+struct ReportsOwnerDeath : std::false_type
+{
+};
+
+template<typename MutexImplT>
+struct ReportsOwnerDeath<MutexImplT,
+                         std::void_t<decltype(std::declval<MutexImplT&>().take_owner_died())>> :
+    std::true_type
+{
+};
+
+template<typename MutexImplT>
+inline constexpr bool reports_owner_death_v = ReportsOwnerDeath<MutexImplT>::value;
+
+//! The result of a callable that might not be run: a bool if it returns void, otherwise an optional
+//! of its result
+template<typename ResultT>
+using MaybeResult =
+    std::conditional_t<std::is_void_v<ResultT>, bool, std::optional<std::decay_t<ResultT>>>;
+
+//! Invoke @p function, wrapping its result in a MaybeResult
+template<typename FunctionT, typename... ArgsT>
+MaybeResult<std::invoke_result_t<FunctionT, ArgsT...>> invoke_maybe(FunctionT&& function,
+                                                                    ArgsT&&... args)
+{
+    if constexpr (std::is_void_v<std::invoke_result_t<FunctionT, ArgsT...>>)
+    {
+        std::invoke(std::forward<FunctionT>(function), std::forward<ArgsT>(args)...);
+        return true;
+    } else
+    {
+        return std::invoke(std::forward<FunctionT>(function), std::forward<ArgsT>(args)...);
+    }
+}
+
+//! The change counter a guard bumps when it's released, according to the @p VersionT policy
+//!
+//! The Unversioned counter is empty, so that guards on an unversioned Mutex don't carry a pointer.
+template<typename VersionT>
+struct GuardVersion;
+
+template<>
+struct GuardVersion<Unversioned>
+{
+    explicit GuardVersion(std::atomic<std::uint64_t>* /*unused*/) noexcept {}
+
+    void bump_version() const noexcept {}
+};
+
+template<>
+struct GuardVersion<Versioned>
+{
+    explicit GuardVersion(std::atomic<std::uint64_t>* version) noexcept : m_version(version) {}
+
+    void bump_version() const noexcept
+    {
+        if (m_version != nullptr)
+        {
+            m_version->fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    std::atomic<std::uint64_t>* m_version;
+};
+}  // namespace rmx::detail
 
 namespace rmx {
 
 //! An RAII-style guard wrapping a reference to some type protected by a mutex
 //!
 //! Acquire a `MutexGuard` by locking a `Mutex`.
-template<typename ValueT, typename MutexImplT>
-class MutexGuard
+template<typename ValueT, typename MutexImplT, typename VersionT = Unversioned>
+class MutexGuard : private detail::GuardVersion<VersionT>
 {
+    using Version = detail::GuardVersion<VersionT>;
+
   public:
     explicit MutexGuard(ValueT& value_ref,
                         std::unique_lock<MutexImplT>&& lock,
-                        bool& was_poisoned) noexcept :
-        m_lock(std::move(lock)), m_ref(value_ref), m_was_poisoned(was_poisoned)
+                        bool& was_poisoned,
+                        std::atomic<std::uint64_t>* version = nullptr) noexcept :
+        Version(version),
+        m_lock(std::move(lock)),
+        m_ref(value_ref),
+        m_was_poisoned(was_poisoned),
+        m_exceptions(std::uncaught_exceptions())
     {
     }
 
@@ -33,14 +196,21 @@ class MutexGuard
     //! If this guard, which represents locked data, is destructed when an exception was thrown,
     //! then that means whatever transaction that was expected to be performed while it was locked,
     //! was unfinished, leaving the locked data in an indeterminate state.
+    //!
+    //! Only exceptions thrown since the guard was made count, so that a guard taken while another
+    //! exception was already unwinding, e.g. from a destructor, doesn't poison the Mutex by itself.
     virtual ~MutexGuard()
     {
-        if (std::uncaught_exceptions() != 0)
+        if (m_lock.owns_lock() && std::uncaught_exceptions() > m_exceptions)
         {
             // TODO: A possible enhancement is to stash the thread::id or possibly the
             // exception.what() so that it can be referenced in the poison exception.
             m_was_poisoned.get() = true;
         }
+        if (m_lock.owns_lock())
+        {
+            this->bump_version();
+        }
     }
 
     //! Access the underlying value by reference
@@ -66,22 +236,346 @@ class MutexGuard
     std::unique_lock<MutexImplT> m_lock;
     std::reference_wrapper<ValueT> m_ref;
     std::reference_wrapper<bool> m_was_poisoned;
+    int m_exceptions;
 };
 
+//! An RAII-style guard wrapping a read-only reference to some type protected by a shared mutex
+//!
+//! Any number of read guards may exist at once. Since the value can't be mutated through a read
+//! guard, an exception thrown while it's held doesn't poison the Mutex.
+//!
+//! Acquire a `MutexReadGuard` by locking a `const Mutex`.
+template<typename ValueT, typename MutexImplT>
+class MutexReadGuard
+{
+  public:
+    explicit MutexReadGuard(const ValueT& value_ref, std::shared_lock<MutexImplT>&& lock) noexcept :
+        m_lock(std::move(lock)), m_ref(value_ref)
+    {
+    }
+
+    MutexReadGuard(MutexReadGuard&&) noexcept = default;
+    MutexReadGuard& operator=(MutexReadGuard&&) noexcept = default;
+
+    MutexReadGuard(const MutexReadGuard&) = delete;
+    MutexReadGuard& operator=(const MutexReadGuard&) = delete;
+
+    ~MutexReadGuard() = default;
+
+    //! Access the underlying value by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] const ValueT& operator*() const noexcept { return m_ref; }
+
+    //! Access the underlying value by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &m_ref.get(); }
+
+    //! Provide access to the underlying std::shared_lock to facilitate use with
+    //! std::condition_variable_any::wait()
+    //!
+    //! @warning It is incorrect to access the wrapped value if the inner lock has been manually
+    //! unlocked. Don't do that.
+    [[nodiscard]] std::shared_lock<MutexImplT>& inner() noexcept { return m_lock; }
+
+  private:
+    std::shared_lock<MutexImplT> m_lock;
+    std::reference_wrapper<const ValueT> m_ref;
+};
+
+//! An RAII-style guard that applies mutations to a private copy of the locked value
+//!
+//! The copy is made lazily on the first mutable access. If the guard is destructed normally, the
+//! copy is committed back into the Mutex. If it's destructed because an exception was thrown, the
+//! copy is discarded, leaving the original value untouched and the Mutex unpoisoned.
+//!
+//! Acquire a `ShadowGuard` by calling `Mutex::lock_shadowed()`.
+template<typename ValueT, typename MutexImplT, typename VersionT = Unversioned>
+class ShadowGuard : private detail::GuardVersion<VersionT>
+{
+    using Version = detail::GuardVersion<VersionT>;
+
+  public:
+    explicit ShadowGuard(ValueT& value_ref,
+                         std::unique_lock<MutexImplT>&& lock,
+                         std::atomic<std::uint64_t>* version = nullptr) noexcept :
+        Version(version),
+        m_lock(std::move(lock)),
+        m_ref(value_ref),
+        m_exceptions(std::uncaught_exceptions())
+    {
+    }
+
+    ShadowGuard(ShadowGuard&&) noexcept = default;
+    ShadowGuard& operator=(ShadowGuard&&) noexcept = default;
+
+    ShadowGuard(const ShadowGuard&) = delete;
+    ShadowGuard& operator=(const ShadowGuard&) = delete;
+
+    //! Commit the shadow copy, unless the guard is being destructed by an exception
+    ~ShadowGuard()
+    {
+        if (m_lock.owns_lock() && m_shadow.has_value() &&
+            std::uncaught_exceptions() <= m_exceptions)
+        {
+            m_ref.get() = std::move(*m_shadow);
+            this->bump_version();
+        }
+    }
+
+    //! Access the shadow copy by reference, making it if necessary
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] ValueT& operator*() { return shadow(); }
+    [[nodiscard]] const ValueT& operator*() const noexcept { return current(); }
+
+    //! Access the shadow copy by pointer, making it if necessary
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] ValueT* operator->() { return &shadow(); }
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &current(); }
+
+    //! Discard any changes made through this guard so far
+    void rollback() noexcept { m_shadow.reset(); }
+
+  private:
+    std::unique_lock<MutexImplT> m_lock;
+    std::reference_wrapper<ValueT> m_ref;
+    std::optional<ValueT> m_shadow;
+    int m_exceptions;
+
+    ValueT& shadow()
+    {
+        if (!m_shadow.has_value())
+        {
+            m_shadow.emplace(m_ref.get());
+        }
+        return *m_shadow;
+    }
+
+    const ValueT& current() const noexcept
+    {
+        return m_shadow.has_value() ? *m_shadow : m_ref.get();
+    }
+};
+
+//! An RAII-style guard that mutates the locked value in place, and records an undo log
+//!
+//! Each mutation made through the guard should be paired with a call to `on_rollback()` that
+//! reverts it. If the guard is destructed because an exception was thrown, the undo log is replayed
+//! in reverse order, restoring the value without poisoning the Mutex. If replaying the undo log
+//! itself throws, the value is left in an indeterminate state, and the Mutex is poisoned.
+//!
+//! Acquire a `TransactionGuard` by calling `Mutex::lock_transaction()`.
+template<typename ValueT, typename MutexImplT, typename VersionT = Unversioned>
+class TransactionGuard : private detail::GuardVersion<VersionT>
+{
+    using Version = detail::GuardVersion<VersionT>;
+
+  public:
+    using UndoFn = std::function<void(ValueT&)>;
+
+    explicit TransactionGuard(ValueT& value_ref,
+                              std::unique_lock<MutexImplT>&& lock,
+                              bool& was_poisoned,
+                              std::atomic<std::uint64_t>* version = nullptr) noexcept :
+        Version(version),
+        m_lock(std::move(lock)),
+        m_ref(value_ref),
+        m_was_poisoned(was_poisoned),
+        m_exceptions(std::uncaught_exceptions())
+    {
+    }
+
+    TransactionGuard(TransactionGuard&&) noexcept = default;
+    TransactionGuard& operator=(TransactionGuard&&) noexcept = default;
+
+    TransactionGuard(const TransactionGuard&) = delete;
+    TransactionGuard& operator=(const TransactionGuard&) = delete;
+
+    //! Replay the undo log if the guard is being destructed by an exception
+    ~TransactionGuard()
+    {
+        if (!m_lock.owns_lock())
+        {
+            return;
+        }
+        if (std::uncaught_exceptions() > m_exceptions)
+        {
+            rollback();
+        }
+        // Mutations without a matching undo action survive a rollback, so count it as a change
+        this->bump_version();
+    }
+
+    //! Access the underlying value by reference
+    //!
+    //! @warning It is incorrect to store the reference returned by this operator.
+    [[nodiscard]] ValueT& operator*() noexcept { return m_ref; }
+    [[nodiscard]] const ValueT& operator*() const noexcept { return m_ref; }
+
+    //! Access the underlying value by pointer
+    //!
+    //! @warning It is incorrect to store the pointer returned by this operator.
+    [[nodiscard]] ValueT* operator->() noexcept { return &m_ref.get(); }
+    [[nodiscard]] const ValueT* operator->() const noexcept { return &m_ref.get(); }
+
+    //! Record an action that reverts the most recent mutation
+    void on_rollback(UndoFn undo) { m_undo_log.push_back(std::move(undo)); }
+
+    //! Revert every mutation recorded so far, and clear the undo log
+    void rollback() noexcept
+    {
+        try
+        {
+            while (!m_undo_log.empty())
+            {
+                m_undo_log.back()(m_ref.get());
+                m_undo_log.pop_back();
+            }
+        } catch (...)
+        {
+            m_undo_log.clear();
+            m_was_poisoned.get() = true;
+        }
+    }
+
+  private:
+    std::unique_lock<MutexImplT> m_lock;
+    std::reference_wrapper<ValueT> m_ref;
+    std::reference_wrapper<bool> m_was_poisoned;
+    std::vector<UndoFn> m_undo_log;
+    int m_exceptions;
+};
+
+}  // namespace rmx
+
+namespace rmx::detail {
+//! The members of a Mutex, laid out according to the @p LayoutT policy
+template<typename ValueT, typename MutexImplT, typename LayoutT>
+struct MutexStorage;
+
+template<typename ValueT, typename MutexImplT>
+struct MutexStorage<ValueT, MutexImplT, Compact>
+{
+    explicit MutexStorage(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    template<typename... ArgsT>
+    explicit MutexStorage(std::in_place_t /*unused*/, ArgsT&&... args) :
+        m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    mutable MutexImplT m_mutex;
+    ValueT m_value;
+    bool m_was_poisoned = false;
+};
+
+template<typename ValueT, typename MutexImplT>
+struct MutexStorage<ValueT, MutexImplT, CachePadded>
+{
+    explicit MutexStorage(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    template<typename... ArgsT>
+    explicit MutexStorage(std::in_place_t /*unused*/, ArgsT&&... args) :
+        m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    // Aligning the first member aligns, and pads, the whole Mutex
+    alignas(hardware_destructive_interference_size) alignas(MutexImplT) mutable MutexImplT m_mutex;
+    ValueT m_value;
+    bool m_was_poisoned = false;
+};
+
+template<typename ValueT, typename MutexImplT>
+struct MutexStorage<ValueT, MutexImplT, Colocated>
+{
+    explicit MutexStorage(ValueT&& value) noexcept : m_value(std::move(value)) { check_size(); }
+
+    template<typename... ArgsT>
+    explicit MutexStorage(std::in_place_t /*unused*/, ArgsT&&... args) :
+        m_value{std::forward<ArgsT>(args)...}
+    {
+        check_size();
+    }
+
+    alignas(hardware_destructive_interference_size) alignas(MutexImplT) mutable MutexImplT m_mutex;
+    bool m_was_poisoned = false;
+    ValueT m_value;
+
+    static constexpr void check_size() noexcept
+    {
+        static_assert(sizeof(MutexStorage) == hardware_destructive_interference_size,
+                      "A Colocated Mutex must fit in a single cache line");
+    }
+};
+
+template<typename ValueT, typename MutexImplT>
+struct MutexStorage<ValueT, MutexImplT, Split>
+{
+    explicit MutexStorage(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    template<typename... ArgsT>
+    explicit MutexStorage(std::in_place_t /*unused*/, ArgsT&&... args) :
+        m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    alignas(hardware_destructive_interference_size) alignas(MutexImplT) mutable MutexImplT m_mutex;
+    bool m_was_poisoned = false;
+    alignas(hardware_destructive_interference_size) alignas(ValueT) ValueT m_value;
+};
+
+//! The change counter of a Mutex, according to the @p VersionT policy
+template<typename VersionT>
+struct MutexVersion;
+
+template<>
+struct MutexVersion<Unversioned>
+{
+    static constexpr std::atomic<std::uint64_t>* version_counter() noexcept { return nullptr; }
+};
+
+template<>
+struct MutexVersion<Versioned>
+{
+    std::atomic<std::uint64_t>* version_counter() noexcept { return &m_version; }
+
+    std::atomic<std::uint64_t> m_version{0};
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
 //! A Rust-inspired mutex that wraps some other type.
-template<typename ValueT, typename MutexImplT = std::mutex>
-class Mutex
+//!
+//! The @p LayoutT policy controls how the lock, value, and poison flag are laid out in memory. See
+//! Compact, CachePadded, Colocated, and Split.
+//!
+//! The @p VersionT policy is Unversioned, or Versioned to count changes to the value.
+template<typename ValueT,
+         typename MutexImplT = std::mutex,
+         typename LayoutT = Compact,
+         typename VersionT = Unversioned>
+class Mutex :
+    private detail::MutexStorage<ValueT, MutexImplT, LayoutT>,
+    private detail::MutexVersion<VersionT>
 {
+    using Storage = detail::MutexStorage<ValueT, MutexImplT, LayoutT>;
+    using Version = detail::MutexVersion<VersionT>;
+
   public:
     //! Take ownership of an existing @p ValueT
-    explicit Mutex(ValueT&& value) noexcept : m_value(std::move(value)) {}
+    explicit Mutex(ValueT&& value) noexcept : Storage(std::move(value)) {}
 
     //! Construct a new @p ValueT from the given args, includes default constructor
     //!
     //! @note POD types need to have a constructor or be passed directly.
     template<typename... ArgsT,
              typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
-    explicit Mutex(ArgsT&&... args) : m_value{std::forward<ArgsT>(args)...}
+    explicit Mutex(ArgsT&&... args) : Storage(std::in_place, std::forward<ArgsT>(args)...)
     {
     }
 
@@ -90,20 +584,22 @@ class Mutex
     //! @throws std::runtime_error if the Mutex was locked while an exception was thrown. If this
     //! happens, it means that whatever transaction the lock was protecting was left unfinished,
     //! leaving the locked data in an indeterminate state.
-    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock() noexcept(false)
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT, VersionT> lock() noexcept(false)
     {
+        std::unique_lock<MutexImplT> lock = acquire();
         throw_if_poisoned();
-        return lock_unchecked();
+        return MutexGuard<ValueT, MutexImplT, VersionT>(
+            m_value, std::move(lock), m_was_poisoned, version_counter());
     }
 
     //! Lock the mutex and return an RAII guard controlling access to the underlying value
     //!
     //! @note Depending on the particular @p MutexImplT implementation, locking the mutex might
     //! throw an exception. For most mutexes, this won't throw.
-    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock_unchecked() noexcept
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT, VersionT> lock_unchecked() noexcept
     {
-        std::unique_lock<MutexImplT> lock(m_mutex);
-        return MutexGuard(m_value, std::move(lock), m_was_poisoned);
+        return MutexGuard<ValueT, MutexImplT, VersionT>(
+            m_value, acquire(), m_was_poisoned, version_counter());
     }
 
     //! Attempt to lock the mutex and return an RAII guard controlling access to the underlying
@@ -112,10 +608,16 @@ class Mutex
     //! @throws std::runtime_error if the Mutex was locked while an exception was thrown. If this
     //! happens, it means that whatever transaction the lock was protecting was left unfinished,
     //! leaving the locked data in an indeterminate state.
-    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT>> try_lock() noexcept(false)
+    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT, VersionT>> try_lock() noexcept(false)
     {
-        throw_if_poisoned();
-        return try_lock_unchecked();
+        std::unique_lock<MutexImplT> maybe_lock = try_acquire();
+        if (maybe_lock)
+        {
+            throw_if_poisoned();
+            return std::optional<MutexGuard<ValueT, MutexImplT, VersionT>>(
+                std::in_place, m_value, std::move(maybe_lock), m_was_poisoned, version_counter());
+        }
+        return std::nullopt;
     }
 
     //! Attempt to lock the mutex and return an RAII guard controlling access to the underlying
@@ -123,26 +625,302 @@ class Mutex
     //!
     //! @note Depending on the particular @p MutexImplT implementation, locking the mutex might
     //! throw an exception. For most mutexes, this won't throw.
-    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT>> try_lock_unchecked() noexcept
+    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT, VersionT>>
+    try_lock_unchecked() noexcept
     {
-        std::unique_lock<MutexImplT> maybe_lock(m_mutex, std::try_to_lock);
+        std::unique_lock<MutexImplT> maybe_lock = try_acquire();
+        if (maybe_lock)
+        {
+            return std::optional<MutexGuard<ValueT, MutexImplT, VersionT>>(
+                std::in_place, m_value, std::move(maybe_lock), m_was_poisoned, version_counter());
+        }
+        return std::nullopt;
+    }
+
+    //! Lock the mutex for reading and return an RAII guard providing read-only access to the
+    //! underlying value
+    //!
+    //! Only available when @p MutexImplT is SharedLockable, like std::shared_mutex. Any number of
+    //! readers may hold the lock at once.
+    //!
+    //! @throws std::runtime_error if the Mutex was locked while an exception was thrown.
+    template<typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    [[nodiscard]] MutexReadGuard<ValueT, MutexImplT> lock() const noexcept(false)
+    {
+        std::shared_lock<MutexImplT> lock(m_mutex);
+        throw_if_poisoned();
+        return MutexReadGuard(m_value, std::move(lock));
+    }
+
+    //! Lock the mutex for reading and return an RAII guard providing read-only access to the
+    //! underlying value
+    template<typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    [[nodiscard]] MutexReadGuard<ValueT, MutexImplT> lock_unchecked() const noexcept
+    {
+        std::shared_lock<MutexImplT> lock(m_mutex);
+        return MutexReadGuard(m_value, std::move(lock));
+    }
+
+    //! Attempt to lock the mutex for reading and return an RAII guard providing read-only access
+    //! to the underlying value
+    //!
+    //! @throws std::runtime_error if the Mutex was locked while an exception was thrown.
+    template<typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    [[nodiscard]] std::optional<MutexReadGuard<ValueT, MutexImplT>> try_lock() const noexcept(false)
+    {
+        std::shared_lock<MutexImplT> maybe_lock(m_mutex, std::try_to_lock);
+        if (maybe_lock)
+        {
+            throw_if_poisoned();
+            return std::optional<MutexReadGuard<ValueT, MutexImplT>>(
+                std::in_place, m_value, std::move(maybe_lock));
+        }
+        return std::nullopt;
+    }
+
+    //! Attempt to lock the mutex for reading and return an RAII guard providing read-only access
+    //! to the underlying value
+    template<typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    [[nodiscard]] std::optional<MutexReadGuard<ValueT, MutexImplT>>
+    try_lock_unchecked() const noexcept
+    {
+        std::shared_lock<MutexImplT> maybe_lock(m_mutex, std::try_to_lock);
         if (maybe_lock)
         {
-            return std::optional<MutexGuard<ValueT, MutexImplT>>(
-                std::in_place, m_value, std::move(maybe_lock), m_was_poisoned);
+            return std::optional<MutexReadGuard<ValueT, MutexImplT>>(
+                std::in_place, m_value, std::move(maybe_lock));
         }
         return std::nullopt;
     }
 
+    //! Lock the mutex and return a guard that mutates a copy of the underlying value
+    //!
+    //! Changes are committed when the guard goes out of scope, and discarded if it goes out of
+    //! scope because of an exception, so an exception never poisons the Mutex.
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    [[nodiscard]] ShadowGuard<ValueT, MutexImplT, VersionT> lock_shadowed() noexcept(false)
+    {
+        static_assert(std::is_copy_constructible_v<ValueT>,
+                      "lock_shadowed() requires a copy constructible ValueT");
+        static_assert(std::is_nothrow_move_assignable_v<ValueT>,
+                      "lock_shadowed() requires a nothrow move assignable ValueT");
+        std::unique_lock<MutexImplT> lock = acquire();
+        throw_if_poisoned();
+        return ShadowGuard<ValueT, MutexImplT, VersionT>(
+            m_value, std::move(lock), version_counter());
+    }
+
+    //! Lock the mutex and return a guard that mutates the underlying value in place, and rolls
+    //! back the mutations recorded in its undo log if it goes out of scope because of an exception
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    [[nodiscard]] TransactionGuard<ValueT, MutexImplT, VersionT> lock_transaction() noexcept(false)
+    {
+        std::unique_lock<MutexImplT> lock = acquire();
+        throw_if_poisoned();
+        return TransactionGuard<ValueT, MutexImplT, VersionT>(
+            m_value, std::move(lock), m_was_poisoned, version_counter());
+    }
+
+    //! Lock the mutex, and invoke @p function on the underlying value
+    //!
+    //! Unlike lock(), the caller never holds a guard, which leaves the synchronization strategy up
+    //! to the Mutex. Code written against with(), try_with(), and with_unchecked() works unchanged
+    //! with any other rmx type providing them. The reference passed to @p function must not
+    //! escape it.
+    //!
+    //! @returns the result of @p function
+    //! @throws std::runtime_error if the Mutex has been poisoned. If @p function throws, the
+    //! exception propagates, and poisons the Mutex.
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with(FunctionT&& function) noexcept(false)
+    {
+        auto guard = lock();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! Lock the mutex, and invoke @p function on the underlying value, without checking for poison
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> with_unchecked(FunctionT&& function)
+    {
+        auto guard = lock_unchecked();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! Attempt to lock the mutex, and invoke @p function on the underlying value if it was locked
+    //!
+    //! @returns the result of @p function, or an empty optional if the mutex was already locked.
+    //! If @p function returns void, returns whether it was invoked.
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    template<typename FunctionT>
+    detail::MaybeResult<std::invoke_result_t<FunctionT, ValueT&>>
+    try_with(FunctionT&& function) noexcept(false)
+    {
+        auto guard = try_lock();
+        if (!guard)
+        {
+            return {};
+        }
+        return detail::invoke_maybe(std::forward<FunctionT>(function), **guard);
+    }
+
+    //! Lock the mutex for reading, and invoke @p function on the underlying value
+    //!
+    //! Only available when @p MutexImplT is SharedLockable.
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    template<typename FunctionT,
+             typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    std::invoke_result_t<FunctionT, const ValueT&> with(FunctionT&& function) const noexcept(false)
+    {
+        auto guard = lock();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! Lock the mutex for reading, and invoke @p function on the underlying value, without checking
+    //! for poison
+    template<typename FunctionT,
+             typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    std::invoke_result_t<FunctionT, const ValueT&> with_unchecked(FunctionT&& function) const
+    {
+        auto guard = lock_unchecked();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! Attempt to lock the mutex for reading, and invoke @p function on the underlying value if it
+    //! was locked
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    template<typename FunctionT,
+             typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    detail::MaybeResult<std::invoke_result_t<FunctionT, const ValueT&>>
+    try_with(FunctionT&& function) const noexcept(false)
+    {
+        auto guard = try_lock();
+        if (!guard)
+        {
+            return {};
+        }
+        return detail::invoke_maybe(std::forward<FunctionT>(function), **guard);
+    }
+
+    //! Access the underlying value without locking
+    //!
+    //! @warning This is only correct in single-owner contexts (e.g. initialization or teardown),
+    //! where no other thread holds or can acquire a reference to this Mutex.
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    [[nodiscard]] ValueT& get_mut() & noexcept(false)
+    {
+        throw_if_poisoned();
+        bump_version();
+        return m_value;
+    }
+
+    //! Access the underlying value without locking, or checking for poison
+    //!
+    //! @warning This is only correct in single-owner contexts (e.g. initialization or teardown),
+    //! where no other thread holds or can acquire a reference to this Mutex.
+    [[nodiscard]] ValueT& get_mut_unchecked() & noexcept
+    {
+        bump_version();
+        return m_value;
+    }
+
+    //! Consume the Mutex, and move the underlying value out of it without locking
+    //!
+    //! @throws std::runtime_error if the Mutex has been poisoned.
+    [[nodiscard]] ValueT into_inner() && noexcept(false)
+    {
+        throw_if_poisoned();
+        return std::move(m_value);
+    }
+
+    //! Consume the Mutex, and move the underlying value out of it without locking, or checking for
+    //! poison
+    [[nodiscard]] ValueT into_inner_unchecked() && { return std::move(m_value); }
+
     //! Indicates whether this Mutex has been poisoned
-    [[nodiscard]] bool is_poisoned() noexcept { return m_was_poisoned; }
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_was_poisoned; }
+
+    //! Clear the poisoned state of this Mutex
+    //!
+    //! Use this after recovering the underlying value into a consistent state, for example through
+    //! lock_unchecked().
+    //!
+    //! @warning The poisoned state isn't atomic, so call this while holding a guard on this Mutex,
+    //! or while no other thread can lock it.
+    void clear_poison() noexcept { m_was_poisoned = false; }
+
+    //! The number of times a mutable guard on this Mutex has been released
+    //!
+    //! Only available when @p VersionT is Versioned. Read guards don't count, and neither do
+    //! shadowed guards that discard their changes. Loading the version doesn't lock the Mutex, so
+    //! a caller that derives something from the value can skip locking and recomputing it when
+    //! the version hasn't changed. Read the version while holding a guard to get the version of the
+    //! value under that guard.
+    //!
+    //! @note get_mut() counts as a change, since it hands out a mutable reference.
+    template<typename PolicyT = VersionT,
+             std::enable_if_t<std::is_same_v<PolicyT, Versioned>, bool> = true>
+    [[nodiscard]] std::uint64_t version() const noexcept
+    {
+        return this->m_version.load(std::memory_order_acquire);
+    }
 
   private:
-    MutexImplT m_mutex;
-    ValueT m_value;
-    bool m_was_poisoned = false;
+    using Storage::m_mutex;
+    using Storage::m_value;
+    using Storage::m_was_poisoned;
+    using Version::version_counter;
+
+    void bump_version() noexcept
+    {
+        if constexpr (std::is_same_v<VersionT, Versioned>)
+        {
+            this->m_version.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    std::unique_lock<MutexImplT> acquire() noexcept(false)
+    {
+        std::unique_lock<MutexImplT> lock(m_mutex);
+        detect_owner_death();
+        return lock;
+    }
+
+    std::unique_lock<MutexImplT> try_acquire() noexcept(false)
+    {
+        std::unique_lock<MutexImplT> maybe_lock(m_mutex, std::try_to_lock);
+        if (maybe_lock)
+        {
+            detect_owner_death();
+        }
+        return maybe_lock;
+    }
+
+    //! A robust @p MutexImplT can be acquired after its previous owner died while holding it. That
+    //! leaves the value in the same indeterminate state as an exception would, so poison the Mutex.
+    void detect_owner_death() noexcept
+    {
+        if constexpr (detail::reports_owner_death_v<MutexImplT>)
+        {
+            if (m_mutex.take_owner_died())
+            {
+                m_was_poisoned = true;
+            }
+        }
+    }
 
-    void throw_if_poisoned() noexcept(false)
+    void throw_if_poisoned() const noexcept(false)
     {
         if (is_poisoned())
         {
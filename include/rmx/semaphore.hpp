@@ -0,0 +1,129 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace rmx {
+
+//! A counting semaphore that sleeps on a futex while too few permits are available
+//!
+//! Acquiring and releasing permits is a single atomic operation when nobody has to wait, and
+//! releasing only makes a syscall when somebody is asleep.
+class Semaphore
+{
+  public:
+    explicit Semaphore(std::uint32_t permits = 0) noexcept : m_permits(permits) {}
+
+    Semaphore(const Semaphore&) = delete;
+    Semaphore& operator=(const Semaphore&) = delete;
+
+    //! Wait until @p count permits are available, and take them
+    void acquire(std::uint32_t count = 1) noexcept
+    {
+        while (!try_acquire(count))
+        {
+            const std::uint32_t permits = prepare_wait(count);
+            if (permits < count)
+            {
+                detail::futex_wait(m_permits, permits);
+            }
+            finish_wait(count);
+        }
+    }
+
+    //! Take @p count permits if they're available, without waiting
+    [[nodiscard]] bool try_acquire(std::uint32_t count = 1) noexcept
+    {
+        std::uint32_t permits = m_permits.load(std::memory_order_relaxed);
+        while (permits >= count)
+        {
+            if (m_permits.compare_exchange_weak(
+                    permits, permits - count, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Wait up to @p timeout for @p count permits to be available, and take them
+    //!
+    //! @returns false if the timeout elapsed first
+    template<typename RepT, typename PeriodT>
+    [[nodiscard]] bool try_acquire_for(const std::chrono::duration<RepT, PeriodT>& timeout,
+                                       std::uint32_t count = 1) noexcept
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!try_acquire(count))
+        {
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining <= std::chrono::nanoseconds::zero())
+            {
+                return false;
+            }
+
+            const std::uint32_t permits = prepare_wait(count);
+            if (permits < count)
+            {
+                detail::futex_wait_for(m_permits, permits, remaining);
+            }
+            finish_wait(count);
+        }
+        return true;
+    }
+
+    //! Return @p count permits, and wake the threads that may now be able to take them
+    void release(std::uint32_t count = 1) noexcept
+    {
+        m_permits.fetch_add(count, std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+        // Waking fewer threads than permits could leave them all with a bulk waiter that still
+        // can't proceed, while a single-permit waiter sleeps
+        if (m_bulk_waiters.load(std::memory_order_relaxed) != 0)
+        {
+            detail::futex_wake_all(m_permits);
+        } else
+        {
+            detail::futex_wake(m_permits, static_cast<int>(count));
+        }
+    }
+
+    //! The number of permits available right now
+    [[nodiscard]] std::uint32_t available() const noexcept
+    {
+        return m_permits.load(std::memory_order_relaxed);
+    }
+
+  private:
+    //! Register as a waiter, and return the permits available after doing so
+    std::uint32_t prepare_wait(std::uint32_t count) noexcept
+    {
+        if (count > 1)
+        {
+            m_bulk_waiters.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_permits.load(std::memory_order_seq_cst);
+    }
+
+    void finish_wait(std::uint32_t count) noexcept
+    {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (count > 1)
+        {
+            m_bulk_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint32_t> m_permits;
+    std::atomic<std::uint32_t> m_waiters{0};
+    std::atomic<std::uint32_t> m_bulk_waiters{0};
+};
+
+}  // namespace rmx
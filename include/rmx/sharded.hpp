@@ -0,0 +1,180 @@
+#pragma once
+#include <rmx/rmx.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! Mix the bits of a hash, since standard library hashes are often the identity function
+[[nodiscard]] inline std::uint64_t mix_hash(std::size_t hash) noexcept
+{
+    constexpr std::uint64_t golden_ratio = 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::uint64_t>(hash) * golden_ratio;
+}
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A Mutex split into @p v_Shards independently locked shards, for hash-partitioned state
+//!
+//! Each key maps to one shard, so threads working on different keys rarely contend. Every shard is
+//! cache padded, so that locking one doesn't invalidate its neighbors.
+//!
+//! @code
+//! rmx::ShardedMutex<std::unordered_map<Key, Value>, 16> map;
+//! {
+//!     auto shard = map.lock(key);
+//!     (*shard)[key] = value;
+//! }
+//! @endcode
+template<typename ValueT, std::size_t v_Shards, typename MutexImplT = std::mutex>
+class ShardedMutex
+{
+    static_assert(v_Shards > 0, "A ShardedMutex needs at least one shard");
+
+  public:
+    using Shard = Mutex<ValueT, MutexImplT, CachePadded>;
+
+    //! Default construct every shard's value
+    ShardedMutex() = default;
+
+    //! Construct every shard's value from the given args
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, const ArgsT&...>, bool> =
+                 true>
+    explicit ShardedMutex(const ArgsT&... args) :
+        m_shards(make_shards(std::make_index_sequence<v_Shards>{}, args...))
+    {
+    }
+
+    [[nodiscard]] static constexpr std::size_t shard_count() noexcept { return v_Shards; }
+
+    //! The index of the shard that @p key belongs to
+    template<typename KeyT, typename HashT = std::hash<KeyT>>
+    [[nodiscard]] static std::size_t shard_index(const KeyT& key) noexcept
+    {
+        // Without mixing, keys that are equal modulo v_Shards would all land in one shard, and
+        // consecutive keys would be spread in lockstep with their buckets inside the shard.
+        return shard_index_of_hash(detail::mix_hash(HashT{}(key)));
+    }
+
+    //! The index of the shard that a key with the given mixed hash belongs to
+    [[nodiscard]] static std::size_t shard_index_of_hash(std::uint64_t mixed_hash) noexcept
+    {
+        return static_cast<std::size_t>((mixed_hash >> 32U) % v_Shards);
+    }
+
+    //! Access the shard at the given index
+    [[nodiscard]] Shard& shard(std::size_t index) noexcept { return m_shards[index]; }
+    [[nodiscard]] const Shard& shard(std::size_t index) const noexcept { return m_shards[index]; }
+
+    //! Lock the shard that @p key belongs to
+    //!
+    //! @throws std::runtime_error if that shard has been poisoned.
+    template<typename KeyT, typename HashT = std::hash<KeyT>>
+    [[nodiscard]] MutexGuard<ValueT, MutexImplT> lock(const KeyT& key) noexcept(false)
+    {
+        return m_shards[shard_index<KeyT, HashT>(key)].lock();
+    }
+
+    //! Lock the shard that @p key belongs to for reading
+    //!
+    //! Only available when @p MutexImplT is SharedLockable.
+    //!
+    //! @throws std::runtime_error if that shard has been poisoned.
+    template<typename KeyT,
+             typename HashT = std::hash<KeyT>,
+             typename ImplT = MutexImplT,
+             std::enable_if_t<detail::is_shared_lockable_v<ImplT>, bool> = true>
+    [[nodiscard]] MutexReadGuard<ValueT, MutexImplT> lock(const KeyT& key) const noexcept(false)
+    {
+        return m_shards[shard_index<KeyT, HashT>(key)].lock();
+    }
+
+    //! Attempt to lock the shard that @p key belongs to
+    //!
+    //! @throws std::runtime_error if that shard has been poisoned.
+    template<typename KeyT, typename HashT = std::hash<KeyT>>
+    [[nodiscard]] std::optional<MutexGuard<ValueT, MutexImplT>>
+    try_lock(const KeyT& key) noexcept(false)
+    {
+        return m_shards[shard_index<KeyT, HashT>(key)].try_lock();
+    }
+
+    //! Lock every shard, in index order, for operations that span the whole ShardedMutex
+    //!
+    //! Since every caller locks the shards in the same order, this can't deadlock with another
+    //! lock_all(), but it will deadlock if the calling thread already holds a shard's lock.
+    //!
+    //! @throws std::runtime_error if any shard has been poisoned. Every shard is unlocked again
+    //! before throwing, without poisoning the others.
+    [[nodiscard]] std::array<MutexGuard<ValueT, MutexImplT>, v_Shards> lock_all() noexcept(false)
+    {
+        return lock_all(std::make_index_sequence<v_Shards>{});
+    }
+
+    //! Lock each shard in turn, and call @p function on its value
+    //!
+    //! Only one shard is locked at a time, so this doesn't observe a consistent snapshot across
+    //! shards. Use lock_all() for that.
+    //!
+    //! @throws std::runtime_error if a shard has been poisoned.
+    template<typename FunctionT>
+    void for_each_shard(FunctionT&& function) noexcept(false)
+    {
+        for (auto& shard : m_shards)
+        {
+            auto value = shard.lock();
+            function(*value);
+        }
+    }
+
+    //! Indicates whether any shard has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept
+    {
+        for (const auto& shard : m_shards)
+        {
+            if (shard.is_poisoned())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    std::array<Shard, v_Shards> m_shards;
+
+    template<std::size_t... v_Indices, typename... ArgsT>
+    static std::array<Shard, v_Shards> make_shards(std::index_sequence<v_Indices...> /*unused*/,
+                                                    const ArgsT&... args)
+    {
+        return {{(static_cast<void>(v_Indices), Shard(args...))...}};
+    }
+
+    template<std::size_t... v_Indices>
+    std::array<MutexGuard<ValueT, MutexImplT>, v_Shards>
+    lock_all(std::index_sequence<v_Indices...> /*unused*/) noexcept(false)
+    {
+        using Guard = MutexGuard<ValueT, MutexImplT>;
+        {
+            // Braced initializers are evaluated in order
+            std::array<Guard, v_Shards> guards{{m_shards[v_Indices].lock_unchecked()...}};
+            if (!is_poisoned())
+            {
+                return {{Guard(std::move(guards[v_Indices]))...}};
+            }
+            // Guards destroyed while unwinding would poison their shards, so release them first
+        }
+        throw std::runtime_error("Mutex poisoned: exception thrown while Mutex was locked");
+    }
+};
+
+}  // namespace rmx
@@ -0,0 +1,278 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+#include <rmx/rmx.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rmx::detail {
+//! A closure queued on a Strand
+template<typename ValueT>
+struct StrandTask
+{
+    virtual ~StrandTask() = default;
+
+    //! Run the closure on @p value, unless the Strand is @p poisoned
+    //!
+    //! @returns false if the closure threw an exception
+    virtual bool run(ValueT& /*value*/, bool /*poisoned*/) noexcept { return true; }
+
+    std::atomic<StrandTask*> m_next{nullptr};
+};
+
+//! A fire-and-forget closure, dropped if the Strand is poisoned
+template<typename ValueT, typename FunctionT>
+struct PostedTask final : StrandTask<ValueT>
+{
+    explicit PostedTask(FunctionT function) : m_function(std::move(function)) {}
+
+    bool run(ValueT& value, bool poisoned) noexcept override
+    {
+        if (poisoned)
+        {
+            return true;
+        }
+        try
+        {
+            std::invoke(m_function, value);
+        } catch (...)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    FunctionT m_function;
+};
+
+//! A closure whose result, or exception, is delivered through a std::future
+template<typename ValueT, typename FunctionT>
+struct SubmittedTask final : StrandTask<ValueT>
+{
+    using ResultT = std::invoke_result_t<FunctionT&, ValueT&>;
+
+    explicit SubmittedTask(FunctionT function) : m_function(std::move(function)) {}
+
+    bool run(ValueT& value, bool poisoned) noexcept override
+    {
+        try
+        {
+            if (poisoned)
+            {
+                throw std::runtime_error("Strand poisoned: exception thrown by an earlier closure");
+            }
+            if constexpr (std::is_void_v<ResultT>)
+            {
+                std::invoke(m_function, value);
+                m_promise.set_value();
+            } else
+            {
+                m_promise.set_value(std::invoke(m_function, value));
+            }
+        } catch (...)
+        {
+            m_promise.set_exception(std::current_exception());
+            // Rejecting a closure because of an earlier exception doesn't count as a new one
+            return poisoned;
+        }
+        return true;
+    }
+
+    FunctionT m_function;
+    std::promise<ResultT> m_promise;
+};
+
+//! An intrusive, unbounded, lock-free multi-producer single-consumer queue
+//!
+//! Pushing is wait-free. Popping is lock-free, except that a pop racing with a push may briefly see
+//! the queue as empty.
+template<typename NodeT>
+class MpscQueue
+{
+  public:
+    MpscQueue() noexcept : m_head(&m_stub), m_tail(&m_stub) {}
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(NodeT* node) noexcept
+    {
+        node->m_next.store(nullptr, std::memory_order_relaxed);
+        NodeT* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        // Until this store, the node is pushed but unreachable from the tail
+        previous->m_next.store(node, std::memory_order_release);
+    }
+
+    //! Pop the oldest node, or return nullptr if there's none, or if it hasn't been linked yet
+    //!
+    //! @note Only one thread may pop at a time.
+    [[nodiscard]] NodeT* pop() noexcept
+    {
+        NodeT* tail = m_tail;
+        NodeT* next = tail->m_next.load(std::memory_order_acquire);
+        if (tail == &m_stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->m_next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+        if (tail != m_head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        // The tail is the last node, so put the stub behind it before popping it
+        push(&m_stub);
+        next = tail->m_next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+  private:
+    alignas(hardware_destructive_interference_size) std::atomic<NodeT*> m_head;
+    alignas(hardware_destructive_interference_size) NodeT* m_tail;
+    NodeT m_stub;
+};
+}  // namespace rmx::detail
+
+namespace rmx {
+
+//! A serial executor that owns a value, and runs closures on it one at a time
+//!
+//! There's no dedicated thread. Posting a closure never waits for a lock: whichever thread posts
+//! to an idle Strand becomes its drainer, and runs queued closures until the queue is empty, while
+//! every other thread's post() returns immediately.
+//!
+//! @warning A closure must not wait on a future returned from submit() on the same Strand, because
+//! it would be waiting on its own drainer.
+template<typename ValueT>
+class Strand
+{
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit Strand(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit Strand(ArgsT&&... args) : m_value{std::forward<ArgsT>(args)...}
+    {
+    }
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    //! The Strand must be idle when it's destroyed
+    ~Strand() = default;
+
+    //! Queue @p function to be run on the value, without waiting for it
+    //!
+    //! If @p function throws, the Strand is poisoned, and queued closures are dropped.
+    //!
+    //! @throws std::runtime_error if the Strand has been poisoned.
+    template<typename FunctionT>
+    void post(FunctionT&& function) noexcept(false)
+    {
+        using TaskT = detail::PostedTask<ValueT, std::decay_t<FunctionT>>;
+        throw_if_poisoned();
+        enqueue(std::make_unique<TaskT>(std::forward<FunctionT>(function)));
+    }
+
+    //! Queue @p function to be run on the value, and return a future for its result
+    //!
+    //! If @p function throws, the exception is delivered through the future, and the Strand is
+    //! poisoned. Closures queued behind it fail with std::runtime_error.
+    //!
+    //! @throws std::runtime_error if the Strand has been poisoned.
+    template<typename FunctionT>
+    [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<FunctionT>&, ValueT&>>
+    submit(FunctionT&& function) noexcept(false)
+    {
+        using TaskT = detail::SubmittedTask<ValueT, std::decay_t<FunctionT>>;
+        static_assert(!std::is_reference_v<typename TaskT::ResultT>,
+                      "References to the value must not escape the Strand");
+        throw_if_poisoned();
+        auto task = std::make_unique<TaskT>(std::forward<FunctionT>(function));
+        auto future = task->m_promise.get_future();
+        enqueue(std::move(task));
+        return future;
+    }
+
+    //! Indicates whether a closure run on this Strand has thrown an exception
+    [[nodiscard]] bool is_poisoned() const noexcept
+    {
+        return m_was_poisoned.load(std::memory_order_acquire);
+    }
+
+    //! Clear the poisoned state of this Strand
+    //!
+    //! Closures posted after this are run again, so use it once a closure has been queued to
+    //! recover the value into a consistent state.
+    void clear_poison() noexcept { m_was_poisoned.store(false, std::memory_order_release); }
+
+  private:
+    using Task = detail::StrandTask<ValueT>;
+
+    void enqueue(std::unique_ptr<Task> task) noexcept
+    {
+        m_queue.push(task.release());
+        if (m_pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            drain();
+        }
+    }
+
+    //! Run queued closures until the queue is empty
+    void drain() noexcept
+    {
+        do
+        {
+            Task* task = m_queue.pop();
+            // The task was counted after it was pushed, so it's only waiting to be linked
+            while (task == nullptr)
+            {
+                detail::cpu_relax();
+                task = m_queue.pop();
+            }
+            if (!task->run(m_value, m_was_poisoned.load(std::memory_order_relaxed)))
+            {
+                m_was_poisoned.store(true, std::memory_order_release);
+            }
+            delete task;
+        } while (m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1);
+    }
+
+    void throw_if_poisoned() const noexcept(false)
+    {
+        if (is_poisoned())
+        {
+            throw std::runtime_error("Strand poisoned: exception thrown by an earlier closure");
+        }
+    }
+
+    detail::MpscQueue<Task> m_queue;
+    alignas(hardware_destructive_interference_size) std::atomic<std::size_t> m_pending{0};
+    std::atomic<bool> m_was_poisoned{false};
+    ValueT m_value;
+};
+
+}  // namespace rmx
@@ -0,0 +1,214 @@
+#pragma once
+#include <rmx/detail/futex.hpp>
+#include <rmx/rmx.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+namespace rmx {
+
+//! A value that one or more writers publish, and that any number of readers borrow and watch for
+//! changes
+//!
+//! Every write bumps a version number, which readers can load without locking, and which they can
+//! sleep on with wait_changed() instead of polling. Waking readers only costs a syscall when a
+//! reader is actually asleep.
+//!
+//! @code
+//! rmx::Watch<Config> config;
+//!
+//! std::uint32_t seen = config.version();
+//! for (;;)
+//! {
+//!     seen = config.wait_changed(seen);
+//!     apply(*config.borrow());
+//! }
+//! @endcode
+template<typename ValueT, typename MutexImplT = std::shared_mutex>
+class Watch
+{
+    static_assert(detail::is_shared_lockable_v<MutexImplT>,
+                  "Watch requires a SharedLockable MutexImplT, like std::shared_mutex");
+
+  public:
+    //! Take ownership of an existing @p ValueT
+    explicit Watch(ValueT&& value) noexcept : m_value(std::move(value)) {}
+
+    //! Construct a new @p ValueT from the given args, includes default constructor
+    template<typename... ArgsT,
+             typename std::enable_if_t<std::is_constructible_v<ValueT, ArgsT...>, bool> = true>
+    explicit Watch(ArgsT&&... args) : m_value(std::forward<ArgsT>(args)...)
+    {
+    }
+
+    //! Replace the value, and wake every reader waiting for it to change
+    //!
+    //! @throws std::runtime_error if the Watch has been poisoned.
+    void publish(ValueT value) noexcept(false)
+    {
+        modify([&value](ValueT& current) { current = std::move(value); });
+    }
+
+    //! Lock the value, invoke @p function on it, and wake every reader waiting for it to change
+    //!
+    //! The version is bumped whether or not @p function changes the value.
+    //!
+    //! @returns the result of @p function
+    //! @throws std::runtime_error if the Watch has been poisoned. If @p function throws, the
+    //! exception propagates, poisons the Watch, and still wakes the waiting readers.
+    template<typename FunctionT>
+    std::invoke_result_t<FunctionT, ValueT&> modify(FunctionT&& function) noexcept(false)
+    {
+        // Declared before the guard, so waiters are woken after the lock is released
+        Notifier notifier(*this);
+        auto guard = m_value.lock();
+        notifier.bump();
+        return std::invoke(std::forward<FunctionT>(function), *guard);
+    }
+
+    //! Lock the value for reading
+    //!
+    //! The version is only bumped under the exclusive lock, so version() read while holding the
+    //! guard is the version of the borrowed value.
+    //!
+    //! @throws std::runtime_error if the Watch has been poisoned.
+    [[nodiscard]] MutexReadGuard<ValueT, MutexImplT> borrow() const noexcept(false)
+    {
+        return m_value.lock();
+    }
+
+    //! Lock the value for reading, without checking for poison
+    [[nodiscard]] MutexReadGuard<ValueT, MutexImplT> borrow_unchecked() const noexcept
+    {
+        return m_value.lock_unchecked();
+    }
+
+    //! The number of times the value has been written, modulo 2^31
+    [[nodiscard]] std::uint32_t version() const noexcept
+    {
+        return m_word.load(std::memory_order_acquire) >> version_shift;
+    }
+
+    //! Sleep until the version differs from @p last_seen
+    //!
+    //! @returns the new version
+    std::uint32_t wait_changed(std::uint32_t last_seen) const noexcept
+    {
+        for (;;)
+        {
+            std::uint32_t word = m_word.load(std::memory_order_acquire);
+            if (!announce_waiter(word, last_seen))
+            {
+                if ((word >> version_shift) != last_seen)
+                {
+                    return word >> version_shift;
+                }
+                continue;
+            }
+            detail::futex_wait(m_word, word);
+        }
+    }
+
+    //! Sleep until the version differs from @p last_seen, or until @p timeout elapses
+    //!
+    //! @returns the new version, or an empty optional if the timeout elapsed first
+    template<typename RepT, typename PeriodT>
+    std::optional<std::uint32_t>
+    wait_changed_for(std::uint32_t last_seen,
+                     const std::chrono::duration<RepT, PeriodT>& timeout) const noexcept
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;)
+        {
+            std::uint32_t word = m_word.load(std::memory_order_acquire);
+            if (!announce_waiter(word, last_seen))
+            {
+                if ((word >> version_shift) != last_seen)
+                {
+                    return word >> version_shift;
+                }
+                continue;
+            }
+            const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (!detail::futex_wait_for(m_word, word, remaining) && version() == last_seen)
+            {
+                return std::nullopt;
+            }
+        }
+    }
+
+    //! Indicates whether this Watch has been poisoned
+    [[nodiscard]] bool is_poisoned() const noexcept { return m_value.is_poisoned(); }
+
+    //! Clear the poisoned state of this Watch
+    void clear_poison() noexcept { m_value.clear_poison(); }
+
+  private:
+    //! The low bit of the word flags that a reader may be asleep on it, and the rest is the version
+    static constexpr std::uint32_t waiters_bit = 1;
+    static constexpr std::uint32_t version_shift = 1;
+    static constexpr std::uint32_t version_increment = 1U << version_shift;
+
+    //! Bumps the version, and wakes the waiting readers when it goes out of scope
+    class Notifier
+    {
+      public:
+        explicit Notifier(Watch& watch) noexcept : m_watch(watch) {}
+
+        Notifier(const Notifier&) = delete;
+        Notifier& operator=(const Notifier&) = delete;
+
+        ~Notifier()
+        {
+            if ((m_previous & waiters_bit) != 0)
+            {
+                m_watch.m_word.fetch_and(~waiters_bit, std::memory_order_relaxed);
+                detail::futex_wake_all(m_watch.m_word);
+            }
+        }
+
+        void bump() noexcept
+        {
+            m_previous = m_watch.m_word.fetch_add(version_increment, std::memory_order_acq_rel);
+        }
+
+      private:
+        Watch& m_watch;
+        std::uint32_t m_previous = 0;
+    };
+
+    //! Set the waiters bit in @p word, unless the version has moved on from @p last_seen
+    //!
+    //! @returns whether the caller should sleep on the updated @p word
+    bool announce_waiter(std::uint32_t& word, std::uint32_t last_seen) const noexcept
+    {
+        if ((word >> version_shift) != last_seen)
+        {
+            return false;
+        }
+        if ((word & waiters_bit) != 0)
+        {
+            return true;
+        }
+        const std::uint32_t waiting = word | waiters_bit;
+        if (!m_word.compare_exchange_weak(
+                word, waiting, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return false;
+        }
+        word = waiting;
+        return true;
+    }
+
+    Mutex<ValueT, MutexImplT> m_value;
+    mutable std::atomic<std::uint32_t> m_word{0};
+};
+
+}  // namespace rmx
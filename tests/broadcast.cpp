@@ -0,0 +1,234 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/broadcast.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+template<typename BroadcastT>
+void fan_out_in_order(int subscribers)
+{
+    constexpr int events = 10000;
+    BroadcastT broadcast(64);
+
+    std::vector<typename BroadcastT::Receiver> receivers;
+    for (int s = 0; s < subscribers; s++)
+    {
+        receivers.push_back(broadcast.subscribe());
+    }
+
+    std::vector<std::thread> pool;
+    std::vector<int> in_order(subscribers, 0);
+    for (int s = 0; s < subscribers; s++)
+    {
+        pool.emplace_back([&receivers, &in_order, s] {
+            int expected = 0;
+            auto check = [&](const int& event, std::uint64_t sequence) {
+                if (event == expected && sequence == static_cast<std::uint64_t>(expected))
+                {
+                    in_order[s]++;
+                }
+                expected++;
+            };
+            while (receivers[s].read_batch(check) != 0)
+            {
+            }
+        });
+    }
+
+    for (int i = 0; i < events; i++)
+    {
+        broadcast.publish(i);
+    }
+    broadcast.close();
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    REQUIRE(in_order == std::vector<int>(subscribers, events));
+}
+}  // namespace
+
+TEST_CASE("Every subscriber reads every event in order")
+{
+    SECTION("Blocking")
+    {
+        fan_out_in_order<rmx::Broadcast<int>>(4);
+    }
+    SECTION("Yielding")
+    {
+        fan_out_in_order<rmx::Broadcast<int, rmx::SingleProducer, rmx::YieldingWait>>(4);
+    }
+    SECTION("Busy spinning")
+    {
+        // Busy spinning needs a core for each thread, which a CI runner may not have
+        fan_out_in_order<rmx::Broadcast<int, rmx::SingleProducer, rmx::BusySpinWait>>(1);
+    }
+}
+
+TEST_CASE("Multiple producers publish to every subscriber")
+{
+    constexpr int producers = 4;
+    constexpr int events = 2500;
+    rmx::Broadcast<int, rmx::MultiProducer> broadcast(16);
+    auto first = broadcast.subscribe();
+    auto second = broadcast.subscribe();
+
+    auto sum_all = [](auto& receiver, long& total) {
+        while (receiver.read_batch([&total](const int& event, std::uint64_t) { total += event; }))
+        {
+        }
+    };
+    long first_total = 0;
+    long second_total = 0;
+    std::thread first_reader([&] { sum_all(first, first_total); });
+    std::thread second_reader([&] { sum_all(second, second_total); });
+
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; p++)
+    {
+        pool.emplace_back([&broadcast] {
+            for (int i = 1; i <= events; i++)
+            {
+                broadcast.publish(i);
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    broadcast.close();
+    first_reader.join();
+    second_reader.join();
+
+    const long expected = long{producers} * events * (events + 1) / 2;
+    REQUIRE(first_total == expected);
+    REQUIRE(second_total == expected);
+    REQUIRE(first.sequence() == producers * events);
+}
+
+TEST_CASE("Multiple producers take turns at each slot without subscribers")
+{
+    constexpr int producers = 4;
+    constexpr int events = 10000;
+    struct Event
+    {
+        std::atomic<int> m_writers{0};
+    };
+    rmx::Broadcast<Event, rmx::MultiProducer> broadcast(4);
+
+    std::atomic<bool> overlapped{false};
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; p++)
+    {
+        pool.emplace_back([&broadcast, &overlapped] {
+            for (int i = 0; i < events; i++)
+            {
+                broadcast.publish_with([&overlapped](Event& event) {
+                    if (event.m_writers.fetch_add(1) != 0)
+                    {
+                        overlapped = true;
+                    }
+                    std::this_thread::yield();
+                    event.m_writers.fetch_sub(1);
+                });
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    REQUIRE_FALSE(overlapped);
+
+    INFO("Every slot was published in order, so a new subscriber reads the next event");
+    auto receiver = broadcast.subscribe();
+    REQUIRE(receiver.sequence() == producers * events);
+    broadcast.publish_with([](Event&) {});
+    REQUIRE(receiver.try_read_batch([](const Event&, std::uint64_t) {}) == 1);
+}
+
+TEST_CASE("Producers wait for the slowest subscriber")
+{
+    rmx::Broadcast<int> broadcast(4);
+    auto fast = broadcast.subscribe();
+    auto slow = broadcast.subscribe();
+    for (int i = 0; i < 4; i++)
+    {
+        broadcast.publish(i);
+    }
+    REQUIRE(fast.try_read_batch([](const int&, std::uint64_t) {}) == 4);
+
+    std::atomic<bool> published{false};
+    std::thread producer([&] {
+        broadcast.publish(4);
+        published = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(published);
+
+    REQUIRE(slow.recv() == 0);
+    producer.join();
+    REQUIRE(published);
+    REQUIRE(fast.recv() == 4);
+}
+
+TEST_CASE("Read events in batches")
+{
+    rmx::Broadcast<int> broadcast(16);
+    auto receiver = broadcast.subscribe();
+    for (int i = 0; i < 10; i++)
+    {
+        broadcast.publish_with([i](int& event) { event = i * i; });
+    }
+
+    std::vector<int> events;
+    auto collect = [&events](const int& event, std::uint64_t) { events.push_back(event); };
+    REQUIRE(receiver.read_batch(collect, 4) == 4);
+    REQUIRE(events == std::vector<int>{0, 1, 4, 9});
+    REQUIRE(receiver.read_batch(collect) == 6);
+    REQUIRE(receiver.sequence() == 10);
+    REQUIRE(receiver.try_read_batch(collect) == 0);
+    REQUIRE(receiver.try_recv() == std::nullopt);
+}
+
+TEST_CASE("Subscribers only read events published after they subscribe")
+{
+    rmx::Broadcast<int, rmx::SingleProducer, rmx::BlockingWait, 2> broadcast(2);
+    broadcast.publish(1);
+
+    {
+        auto early = broadcast.subscribe();
+        auto late = broadcast.subscribe();
+        REQUIRE(late.sequence() == 1);
+        REQUIRE_THROWS_AS(broadcast.subscribe(), std::runtime_error);
+        broadcast.publish(2);
+        REQUIRE(late.recv() == 2);
+        REQUIRE(early.recv() == 2);
+    }
+
+    INFO("Unsubscribed receivers no longer hold back the producer");
+    for (int i = 3; i < 10; i++)
+    {
+        broadcast.publish(i);
+    }
+    auto receiver = broadcast.subscribe();
+    broadcast.publish(10);
+    REQUIRE(receiver.recv() == 10);
+    broadcast.close();
+    REQUIRE(receiver.recv() == std::nullopt);
+}
+
+TEST_CASE("Broadcast capacities must be powers of two")
+{
+    REQUIRE_THROWS_AS(rmx::Broadcast<int>(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(rmx::Broadcast<int>(12), std::invalid_argument);
+    REQUIRE(rmx::Broadcast<int>(8).capacity() == 8);
+}
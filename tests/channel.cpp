@@ -0,0 +1,231 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/channel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+template<typename ChannelT>
+void exchange_between_threads(ChannelT& channel)
+{
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int messages = 5000;
+    std::atomic<long> total{0};
+    std::atomic<int> received{0};
+    // Catch2 assertions aren't thread safe, so the threads only record failures
+    std::atomic<int> failed_sends{0};
+
+    std::vector<std::thread> senders;
+    for (int p = 0; p < producers; p++)
+    {
+        senders.emplace_back([&channel, &failed_sends] {
+            for (int i = 1; i <= messages; i++)
+            {
+                if (!channel.send(i))
+                {
+                    failed_sends++;
+                }
+            }
+        });
+    }
+    std::vector<std::thread> receivers;
+    for (int c = 0; c < consumers; c++)
+    {
+        receivers.emplace_back([&channel, &total, &received] {
+            while (auto value = channel.recv())
+            {
+                total += *value;
+                received++;
+            }
+        });
+    }
+
+    for (auto& thread : senders)
+    {
+        thread.join();
+    }
+    channel.close();
+    for (auto& thread : receivers)
+    {
+        thread.join();
+    }
+
+    REQUIRE(failed_sends == 0);
+    REQUIRE(received == producers * messages);
+    REQUIRE(total == long{producers} * messages * (messages + 1) / 2);
+}
+}  // namespace
+
+TEST_CASE("Every value sent is received exactly once")
+{
+    SECTION("Unbounded")
+    {
+        rmx::Channel<int> channel;
+        exchange_between_threads(channel);
+    }
+    SECTION("Bounded")
+    {
+        rmx::BoundedChannel<int> channel(8);
+        exchange_between_threads(channel);
+    }
+}
+
+TEST_CASE("A single sender's values are received in order")
+{
+    rmx::Channel<int> unbounded;
+    rmx::BoundedChannel<int> bounded(4);
+
+    std::thread sender([&] {
+        for (int i = 0; i < 1000; i++)
+        {
+            unbounded.send(i);
+            bounded.send(i);
+        }
+    });
+    for (int i = 0; i < 1000; i++)
+    {
+        REQUIRE(bounded.recv() == i);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        REQUIRE(unbounded.recv() == i);
+    }
+    sender.join();
+}
+
+TEST_CASE("A full bounded channel makes senders wait")
+{
+    rmx::BoundedChannel<int> channel(2);
+    REQUIRE(channel.capacity() == 2);
+    REQUIRE_THROWS_AS(rmx::BoundedChannel<int>(0), std::invalid_argument);
+
+    int value = 1;
+    REQUIRE(channel.try_send(value));
+    value = 2;
+    REQUIRE(channel.try_send(value));
+    value = 3;
+    REQUIRE_FALSE(channel.try_send(value));
+    REQUIRE(value == 3);
+
+    std::atomic<bool> sent{false};
+    std::thread sender([&channel, &sent] {
+        channel.send(3);
+        sent = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(sent);
+
+    REQUIRE(channel.recv() == 1);
+    sender.join();
+    REQUIRE(sent);
+    REQUIRE(channel.recv() == 2);
+    REQUIRE(channel.recv() == 3);
+    REQUIRE_FALSE(channel.try_recv());
+}
+
+TEST_CASE("Closing a channel drains it, then wakes receivers")
+{
+    rmx::Channel<int> channel;
+    REQUIRE(channel.send(1));
+    REQUIRE(channel.send(2));
+    channel.close();
+    REQUIRE(channel.is_closed());
+
+    REQUIRE_FALSE(channel.send(3));
+    REQUIRE(channel.recv() == 1);
+    REQUIRE(channel.try_recv() == 2);
+    REQUIRE(channel.recv() == std::nullopt);
+
+    rmx::BoundedChannel<int> empty(1);
+    std::optional<int> received = 0;
+    std::thread receiver([&empty, &received] { received = empty.recv(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    empty.close();
+    receiver.join();
+    REQUIRE(received == std::nullopt);
+}
+
+TEST_CASE("Closing a channel wakes blocked senders")
+{
+    rmx::BoundedChannel<int> channel(1);
+    REQUIRE(channel.send(1));
+
+    bool sent = true;
+    std::thread sender([&channel, &sent] { sent = channel.send(2); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    channel.close();
+    sender.join();
+    REQUIRE_FALSE(sent);
+
+    REQUIRE(channel.recv() == 1);
+    REQUIRE(channel.recv() == std::nullopt);
+}
+
+TEST_CASE("Send and receive in batches")
+{
+    rmx::BoundedChannel<int> channel(16);
+    const std::vector<int> values{1, 2, 3, 4, 5};
+    REQUIRE(channel.send_many(values.begin(), values.end()) == values.size());
+
+    std::vector<int> received;
+    REQUIRE(channel.recv_many(std::back_inserter(received), 3) == 3);
+    REQUIRE(received == std::vector<int>{1, 2, 3});
+    REQUIRE(channel.recv_many(std::back_inserter(received), 16) == 2);
+    REQUIRE(received == values);
+
+    channel.close();
+    REQUIRE(channel.recv_many(std::back_inserter(received), 16) == 0);
+    REQUIRE(channel.send_many(values.begin(), values.end()) == 0);
+}
+
+TEST_CASE("Batches larger than a bounded channel are sent as space frees up")
+{
+    rmx::BoundedChannel<int> channel(4);
+    std::vector<int> values(100);
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+    }
+
+    std::size_t sent = 0;
+    std::thread sender([&] { sent = channel.send_many(values.begin(), values.end()); });
+    std::vector<int> received;
+    while (received.size() < values.size())
+    {
+        channel.recv_many(std::back_inserter(received), 8);
+    }
+    sender.join();
+    REQUIRE(sent == 100);
+    REQUIRE(received == values);
+}
+
+TEST_CASE("Dropping a channel destroys the values it still holds")
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        rmx::Channel<std::shared_ptr<int>> unbounded;
+        rmx::BoundedChannel<std::shared_ptr<int>> bounded(8);
+        for (int i = 0; i < 100; i++)
+        {
+            unbounded.send(counter);
+        }
+        for (int i = 0; i < 40; i++)
+        {
+            REQUIRE(unbounded.recv() == counter);
+        }
+        for (int i = 0; i < 5; i++)
+        {
+            bounded.send(counter);
+        }
+        REQUIRE(bounded.recv() == counter);
+        REQUIRE(counter.use_count() == 1 + 60 + 4);
+    }
+    REQUIRE(counter.use_count() == 1);
+}
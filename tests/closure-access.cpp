@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Invoke a callable under the lock")
+{
+    auto mutex = rmx::Mutex<std::vector<int>>({1, 2, 3});
+
+    mutex.with([](std::vector<int>& v) { v.push_back(4); });
+    const std::size_t size = mutex.with([](std::vector<int>& v) { return v.size(); });
+    REQUIRE(size == 4);
+
+    INFO("Results are returned by value, since references to the value must not escape the call");
+    const int first = mutex.with_unchecked([](std::vector<int>& v) { return v.front(); });
+    REQUIRE(first == 1);
+}
+
+TEST_CASE("Attempt to invoke a callable under the lock")
+{
+    auto mutex = rmx::Mutex<int>(1);
+
+    {
+        INFO("try_with() invokes the callable if the lock is free");
+        std::optional<int> result = mutex.try_with([](int& value) { return ++value; });
+        REQUIRE(result == 2);
+        REQUIRE(mutex.try_with([](int& value) { value = 3; }));
+    }
+
+    {
+        INFO("try_with() doesn't invoke the callable if the lock is held");
+        auto guard = mutex.lock();
+        bool invoked = false;
+        REQUIRE_FALSE(mutex.try_with([&invoked](int&) { invoked = true; }));
+        REQUIRE_FALSE(mutex.try_with([](int& value) { return value; }).has_value());
+        REQUIRE_FALSE(invoked);
+    }
+}
+
+TEST_CASE("Exceptions thrown by the callable poison the Mutex")
+{
+    auto mutex = rmx::Mutex<int>(1);
+
+    REQUIRE_THROWS_AS(mutex.with([](int&) { throw std::logic_error("oops"); }), std::logic_error);
+    REQUIRE(mutex.is_poisoned());
+    REQUIRE_THROWS_AS(mutex.with([](int& value) { return value; }), std::runtime_error);
+    REQUIRE_THROWS_AS(mutex.try_with([](int& value) { return value; }), std::runtime_error);
+
+    REQUIRE(mutex.with_unchecked([](int& value) { return value; }) == 1);
+}
+
+TEST_CASE("Invoke a callable under a shared lock")
+{
+    const auto mutex = rmx::Mutex<std::vector<int>, std::shared_mutex>({1, 2, 3});
+
+    REQUIRE(mutex.with([](const std::vector<int>& v) { return v.size(); }) == 3);
+    REQUIRE(mutex.with_unchecked([](const std::vector<int>& v) { return v.back(); }) == 3);
+
+    INFO("Readers don't exclude each other");
+    auto reader = mutex.lock();
+    REQUIRE(mutex.try_with([](const std::vector<int>& v) { return v.front(); }) == 1);
+}
@@ -0,0 +1,185 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/numa.hpp>
+#include <rmx/rmx.hpp>
+#include <sched.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+//! Pin the calling thread to the given CPU
+bool pin_to_cpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+//! The fake NUMA node of the calling thread
+thread_local std::size_t fake_node = 0;
+
+std::size_t current_fake_node() noexcept
+{
+    return fake_node;
+}
+
+template<typename PredicateT>
+void wait_until(PredicateT&& predicate)
+{
+    while (!predicate())
+    {
+        std::this_thread::yield();
+    }
+}
+}  // namespace
+
+TEST_CASE("Parse sysfs CPU lists")
+{
+    using rmx::NumaTopology;
+    REQUIRE(NumaTopology::parse_cpulist("0") == std::vector<std::size_t>{0});
+    REQUIRE(NumaTopology::parse_cpulist("0-3\n") == std::vector<std::size_t>{0, 1, 2, 3});
+    REQUIRE(NumaTopology::parse_cpulist("0-1,4,6-7") == std::vector<std::size_t>{0, 1, 4, 6, 7});
+    REQUIRE(NumaTopology::parse_cpulist("").empty());
+    REQUIRE_THROWS(NumaTopology::parse_cpulist("3-1"));
+}
+
+TEST_CASE("Discover NUMA topology from sysfs")
+{
+    const auto sysfs = std::filesystem::temp_directory_path() / "rmx-test-sysfs-node";
+    std::filesystem::remove_all(sysfs);
+    std::filesystem::create_directories(sysfs / "node0");
+    std::filesystem::create_directories(sysfs / "node1");
+    std::filesystem::create_directories(sysfs / "power");
+    std::ofstream(sysfs / "node0" / "cpulist") << "0-1,4-5\n";
+    std::ofstream(sysfs / "node1" / "cpulist") << "2-3,6-7\n";
+
+    const auto topology = rmx::NumaTopology::discover(sysfs);
+    REQUIRE(topology.node_count() == 2);
+    REQUIRE(topology.node_of(0) == 0);
+    REQUIRE(topology.node_of(3) == 1);
+    REQUIRE(topology.node_of(5) == 0);
+    REQUIRE(topology.node_of(6) == 1);
+    REQUIRE(topology.node_of(100) == 0);
+
+    std::filesystem::remove_all(sysfs);
+
+    INFO("Missing sysfs falls back to a single node");
+    REQUIRE(rmx::NumaTopology::discover(sysfs).node_count() == 1);
+}
+
+TEST_CASE("Nodes reported out of range count as node 0")
+{
+    const rmx::NumaTopology topology(2, current_fake_node);
+    rmx::CohortMutex cohort(topology);
+
+    fake_node = 5;
+    REQUIRE(topology.current_node() == 0);
+    cohort.lock();
+    REQUIRE(cohort.queued(0) == 1);
+    REQUIRE_FALSE(cohort.try_lock());
+    cohort.unlock();
+    fake_node = 0;
+}
+
+TEST_CASE("Cohort lock provides mutual exclusion")
+{
+    // Alternate CPUs between two fake NUMA nodes, so that any machine with more than one CPU
+    // exercises handing the global lock between nodes.
+    const int cpus = static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<std::size_t> node_of_cpu;
+    for (int cpu = 0; cpu < cpus; cpu++)
+    {
+        node_of_cpu.push_back(static_cast<std::size_t>(cpu % 2));
+    }
+    const rmx::NumaTopology topology(node_of_cpu);
+
+    rmx::CohortMutex cohort(topology, 4);
+    int counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++)
+    {
+        threads.emplace_back([&, i] {
+            pin_to_cpu(i % cpus);
+            for (int j = 0; j < 1000; j++)
+            {
+                cohort.lock();
+                counter++;
+                cohort.unlock();
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(counter == 8000);
+
+    INFO("try_lock() fails while locked");
+    cohort.lock();
+    bool acquired = true;
+    std::thread other([&] { acquired = cohort.try_lock(); });
+    other.join();
+    REQUIRE_FALSE(acquired);
+    cohort.unlock();
+    REQUIRE(cohort.try_lock());
+    cohort.unlock();
+}
+
+TEST_CASE("Cohort lock hands off within a node, up to the threshold")
+{
+    const rmx::NumaTopology topology(2, current_fake_node);
+    rmx::CohortMutex cohort(topology, 2);
+    std::vector<std::size_t> holders;
+
+    fake_node = 0;
+    cohort.lock();
+    holders.push_back(fake_node);
+
+    const auto lock_on = [&](std::size_t node) {
+        return std::thread([&, node] {
+            fake_node = node;
+            cohort.lock();
+            holders.push_back(fake_node);
+            cohort.unlock();
+        });
+    };
+
+    // The node 1 thread takes its local lock, and queues for the global lock first
+    std::vector<std::thread> threads;
+    threads.push_back(lock_on(1));
+    wait_until([&] { return cohort.queued_global() == 2; });
+    // The node 0 threads queue for the local lock held by this thread
+    for (std::uint32_t waiting = 1; waiting <= 3; waiting++)
+    {
+        threads.push_back(lock_on(0));
+        wait_until([&] { return cohort.queued(0) == 1 + waiting; });
+    }
+
+    cohort.unlock();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    INFO("Node 0 keeps the global lock for 2 handoffs, although node 1 queued first, then node 1 "
+         "gets a turn");
+    REQUIRE(holders == std::vector<std::size_t>{0, 0, 0, 1, 0});
+    REQUIRE(cohort.queued_global() == 0);
+}
+
+TEST_CASE("Cohort lock as a Mutex implementation")
+{
+    rmx::Mutex<int, rmx::CohortMutex> mutex(0);
+    {
+        auto value = mutex.lock();
+        *value = 42;
+    }
+    auto value = mutex.try_lock();
+    REQUIRE(value.has_value());
+    REQUIRE(**value == 42);
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/combining.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Combined operations are serialized")
+{
+    constexpr std::size_t threads = 8;
+    constexpr std::size_t iterations = 2000;
+    auto mutex = rmx::CombiningMutex<std::vector<std::size_t>>();
+    std::vector<std::size_t> last_sizes(threads);
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&mutex, &last_sizes, t] {
+            for (std::size_t i = 0; i < iterations; i++)
+            {
+                last_sizes[t] = mutex.with([t](std::vector<std::size_t>& v) {
+                    v.push_back(t);
+                    return v.size();
+                });
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    REQUIRE(mutex.lock()->size() == threads * iterations);
+    for (const std::size_t size : last_sizes)
+    {
+        REQUIRE(size >= iterations);
+        REQUIRE(size <= threads * iterations);
+    }
+}
+
+TEST_CASE("Operations queued behind a held lock are run in one batch by one thread")
+{
+    constexpr int threads = 4;
+    auto mutex = rmx::CombiningMutex<std::vector<std::thread::id>>();
+
+    std::vector<std::thread> pool;
+    {
+        auto guard = mutex.lock();
+        std::atomic<int> publishing{0};
+        for (int t = 0; t < threads; t++)
+        {
+            pool.emplace_back([&mutex, &publishing] {
+                publishing++;
+                mutex.with([](std::vector<std::thread::id>& runners) {
+                    runners.push_back(std::this_thread::get_id());
+                });
+            });
+        }
+        while (publishing != threads)
+        {
+            std::this_thread::yield();
+        }
+        // Give every thread time to publish its operation behind the held lock
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(guard->empty());
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    const std::vector<std::thread::id> runners = *mutex.lock();
+    REQUIRE(runners.size() == threads);
+    for (const std::thread::id runner : runners)
+    {
+        REQUIRE(runner == runners.front());
+    }
+}
+
+TEST_CASE("Combined operations return references and void")
+{
+    auto mutex = rmx::CombiningMutex<std::vector<int>>({1, 2, 3});
+
+    mutex.with([](std::vector<int>& v) { v.push_back(4); });
+    int& last = mutex.with([](std::vector<int>& v) -> int& { return v.back(); });
+    REQUIRE(last == 4);
+
+    std::optional<int> first = mutex.try_with([](std::vector<int>& v) { return v.front(); });
+    REQUIRE(first == 1);
+}
+
+TEST_CASE("try_with() doesn't wait for the lock")
+{
+    auto mutex = rmx::CombiningMutex<int>(1);
+
+    auto guard = mutex.lock();
+    bool invoked = false;
+    REQUIRE_FALSE(mutex.try_with([&invoked](int&) { invoked = true; }));
+    REQUIRE_FALSE(mutex.try_lock().has_value());
+    REQUIRE_FALSE(invoked);
+}
+
+TEST_CASE("Exceptions are rethrown in the publishing thread, and poison the CombiningMutex")
+{
+    auto mutex = rmx::CombiningMutex<int>(1);
+
+    bool threw = false;
+    std::thread thread([&mutex, &threw] {
+        try
+        {
+            mutex.with([](int& value) {
+                value = 2;
+                throw std::logic_error("Throwing an exception while the Mutex is locked");
+            });
+        } catch (const std::logic_error&)
+        {
+            threw = true;
+        }
+    });
+    thread.join();
+
+    REQUIRE(threw);
+    REQUIRE(mutex.is_poisoned());
+    REQUIRE_THROWS_AS(mutex.with([](int& value) { return value; }), std::runtime_error);
+    REQUIRE_THROWS_AS(mutex.try_with([](int& value) { return value; }), std::runtime_error);
+    REQUIRE_THROWS_AS(mutex.lock(), std::runtime_error);
+
+    REQUIRE(mutex.with_unchecked([](int& value) { return value; }) == 2);
+    mutex.clear_poison();
+    REQUIRE(*mutex.lock() == 2);
+}
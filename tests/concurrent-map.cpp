@@ -0,0 +1,260 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/concurrent_map.hpp>
+#include <rmx/rmx.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Concurrent map basic operations")
+{
+    rmx::ConcurrentMap<std::string, int> map;
+    REQUIRE(map.empty());
+
+    REQUIRE(map.insert("one", 1));
+    REQUIRE_FALSE(map.insert("one", 100));
+    REQUIRE(map.get("one") == 1);
+    REQUIRE_FALSE(map.get("two").has_value());
+    REQUIRE(map.contains("one"));
+
+    map.insert_or_assign("one", 11);
+    map.insert_or_assign("two", 2);
+    REQUIRE(map.get("one") == 11);
+    REQUIRE(map.get("two") == 2);
+    REQUIRE(map.size() == 2);
+
+    REQUIRE(map.erase("one"));
+    REQUIRE_FALSE(map.erase("one"));
+    REQUIRE_FALSE(map.contains("one"));
+    REQUIRE(map.size() == 1);
+
+    map.clear();
+    REQUIRE(map.empty());
+}
+
+TEST_CASE("Concurrent map runs callables under the shard lock")
+{
+    rmx::ConcurrentMap<int, std::vector<int>> map;
+
+    const std::size_t size = map.upsert(1, [](std::vector<int>& values) {
+        values.push_back(42);
+        return values.size();
+    });
+    REQUIRE(size == 1);
+
+    {
+        INFO("with() only runs when the key is present");
+        REQUIRE(map.with(1, [](std::vector<int>& values) { values.push_back(43); }));
+        REQUIRE_FALSE(map.with(2, [](std::vector<int>& values) { values.push_back(43); }));
+        const auto& readonly = map;
+        const auto count = [](const std::vector<int>& values) { return values.size(); };
+        REQUIRE(readonly.with(1, count) == 2);
+        REQUIRE_FALSE(readonly.with(2, count).has_value());
+    }
+
+    {
+        INFO("Exceptions poison the key's shard");
+        REQUIRE_THROWS(map.upsert(1, [](std::vector<int>&) { throw std::runtime_error("oops"); }));
+        REQUIRE_THROWS(map.get(1));
+    }
+}
+
+TEST_CASE("Concurrent map grows and erases")
+{
+    rmx::ConcurrentMap<int, int, 4> map;
+    for (int key = 0; key < 10000; key++)
+    {
+        REQUIRE(map.insert(key, key));
+    }
+    REQUIRE(map.size() == 10000);
+
+    for (int key = 0; key < 10000; key += 2)
+    {
+        REQUIRE(map.erase(key));
+    }
+    REQUIRE(map.size() == 5000);
+
+    INFO("Erasing shifts entries back without losing any");
+    for (int key = 0; key < 10000; key++)
+    {
+        REQUIRE(map.contains(key) == (key % 2 == 1));
+    }
+
+    std::size_t visited = 0;
+    map.for_each([&](int key, int value) {
+        REQUIRE(key == value);
+        visited++;
+    });
+    REQUIRE(visited == 5000);
+}
+
+TEST_CASE("Concurrent map recovers from poison")
+{
+    rmx::ConcurrentMap<int, int> map;
+    map.insert(1, 1);
+    const auto throws = [](int& value) {
+        value = 2;
+        throw std::runtime_error("Throwing an exception while the shard is locked");
+    };
+
+    REQUIRE_THROWS_AS(map.upsert(1, throws), std::runtime_error);
+    REQUIRE(map.is_poisoned());
+    REQUIRE_THROWS_AS(map.get(1), std::runtime_error);
+
+    INFO("clear_poison() keeps the entries as the callable left them");
+    map.clear_poison();
+    REQUIRE_FALSE(map.is_poisoned());
+    REQUIRE(map.get(1) == 2);
+
+    INFO("clear() discards a poisoned shard's entries along with its poison");
+    REQUIRE_THROWS_AS(map.upsert(1, throws), std::runtime_error);
+    map.clear();
+    REQUIRE_FALSE(map.is_poisoned());
+    REQUIRE(map.empty());
+    REQUIRE(map.insert(1, 3));
+}
+
+TEST_CASE("Concurrent map shards grow incrementally")
+{
+    rmx::detail::OpenTable<int, int, std::equal_to<int>> table;
+    const auto hash_of = [](int key) { return rmx::detail::mix_hash(std::hash<int>{}(key)); };
+
+    constexpr int keys = 5000;
+    std::size_t growths = 0;
+    std::vector<bool> erased(keys, false);
+    for (int key = 0; key < keys; key++)
+    {
+        const std::size_t capacity = table.capacity();
+        REQUIRE(table.try_emplace(hash_of(key), key, key).second);
+        if (table.capacity() > capacity && capacity != 0)
+        {
+            growths++;
+            INFO("Growing leaves the old slots to be migrated by later operations");
+            REQUIRE(table.is_resizing());
+        }
+
+        if (table.is_resizing() && key % 3 == 0)
+        {
+            REQUIRE(table.erase(hash_of(key / 2), key / 2));
+            erased[key / 2] = true;
+        }
+    }
+    REQUIRE(growths > 5);
+
+    INFO("Every entry stays reachable, whichever set of slots it's in");
+    std::size_t remaining = 0;
+    for (int key = 0; key < keys; key++)
+    {
+        const int* value = table.find(hash_of(key), key);
+        REQUIRE((value == nullptr) == erased[key]);
+        if (value != nullptr)
+        {
+            REQUIRE(*value == key);
+            remaining++;
+        }
+    }
+    REQUIRE(table.size() == remaining);
+    REQUIRE(remaining < keys);
+}
+
+TEST_CASE("Concurrent map concurrent upserts")
+{
+    rmx::ConcurrentMap<int, int> map;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&map] {
+            for (int key = 0; key < 1000; key++)
+            {
+                map.upsert(key, [](int& count) { count++; });
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(map.size() == 1000);
+    for (int key = 0; key < 1000; key++)
+    {
+        REQUIRE(map.get(key) == 4);
+    }
+}
+
+namespace {
+constexpr int bench_threads = 4;
+constexpr int bench_operations = 20000;
+constexpr int bench_keys = 4096;
+
+//! Run @p operation(thread, i) bench_operations times on each of bench_threads threads
+template<typename OperationT>
+void run_threads(OperationT&& operation)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < bench_threads; t++)
+    {
+        threads.emplace_back([&operation, t] {
+            for (int i = 0; i < bench_operations; i++)
+            {
+                operation(t, i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+int bench_key(int thread, int i)
+{
+    return (i * 7919 + thread * 104729) % bench_keys;
+}
+}  // namespace
+
+TEST_CASE("Concurrent map vs a single locked std::unordered_map", "[.][benchmark]")
+{
+    rmx::ConcurrentMap<int, int> map;
+    rmx::Mutex<std::unordered_map<int, int>> baseline;
+
+    BENCHMARK("ConcurrentMap upsert")
+    {
+        run_threads([&](int t, int i) { map.upsert(bench_key(t, i), [](int& v) { v++; }); });
+    };
+    BENCHMARK("Mutex<unordered_map> upsert")
+    {
+        run_threads([&](int t, int i) { (*baseline.lock())[bench_key(t, i)]++; });
+    };
+
+    BENCHMARK("ConcurrentMap 90% reads")
+    {
+        run_threads([&](int t, int i) {
+            if (i % 10 == 0)
+            {
+                map.upsert(bench_key(t, i), [](int& v) { v++; });
+            } else
+            {
+                static_cast<void>(map.get(bench_key(t, i)));
+            }
+        });
+    };
+    BENCHMARK("Mutex<unordered_map> 90% reads")
+    {
+        run_threads([&](int t, int i) {
+            auto locked = baseline.lock();
+            if (i % 10 == 0)
+            {
+                (*locked)[bench_key(t, i)]++;
+            } else
+            {
+                static_cast<void>(locked->find(bench_key(t, i)));
+            }
+        });
+    };
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/cow.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Writes without outstanding snapshots happen in place")
+{
+    auto mutex = rmx::CowMutex<std::vector<int>>({1, 2, 3});
+    const std::vector<int>* original = mutex.snapshot().get();
+
+    {
+        auto value = mutex.write();
+        REQUIRE_FALSE(value.is_copy());
+        value->push_back(4);
+    }
+
+    auto snapshot = mutex.snapshot();
+    REQUIRE(snapshot.get() == original);
+    REQUIRE(*snapshot == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Snapshots are immutable")
+{
+    auto mutex = rmx::CowMutex<std::vector<int>>({1, 2, 3});
+    auto before = mutex.snapshot();
+
+    {
+        auto value = mutex.write();
+        REQUIRE(value.is_copy());
+        value->push_back(4);
+
+        INFO("The copy isn't published until the guard goes out of scope");
+        REQUIRE(before->size() == 3);
+    }
+
+    REQUIRE(*before == std::vector<int>{1, 2, 3});
+    REQUIRE(*mutex.snapshot() == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Long-running readers don't block writers")
+{
+    auto mutex = rmx::CowMutex<int>(1);
+    auto reader = mutex.snapshot();
+
+    std::thread writer([&mutex] {
+        for (int i = 0; i < 100; i++)
+        {
+            *mutex.write() += 1;
+        }
+    });
+    writer.join();
+
+    REQUIRE(*reader == 1);
+    REQUIRE(*mutex.snapshot() == 101);
+}
+
+TEST_CASE("Exceptions discard copies, but poison in-place writes")
+{
+    auto mutex = rmx::CowMutex<int>(1);
+
+    {
+        auto snapshot = mutex.snapshot();
+        try
+        {
+            auto value = mutex.write();
+            *value = 2;
+            throw std::runtime_error("Throwing an exception while the CowMutex is locked");
+        } catch (...)
+        {
+            // ...
+        }
+        REQUIRE_FALSE(mutex.is_poisoned());
+        REQUIRE(*mutex.snapshot() == 1);
+    }
+
+    try
+    {
+        auto value = mutex.write();
+        *value = 3;
+        throw std::runtime_error("Throwing an exception while the CowMutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE(mutex.is_poisoned());
+    REQUIRE_THROWS_AS(mutex.snapshot(), std::runtime_error);
+    REQUIRE_THROWS_AS(mutex.write(), std::runtime_error);
+    REQUIRE(*mutex.snapshot_unchecked() == 3);
+
+    mutex.clear_poison();
+    REQUIRE(*mutex.snapshot() == 3);
+}
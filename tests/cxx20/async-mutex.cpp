@@ -0,0 +1,313 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/async.hpp>
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+//! An eagerly started coroutine, that's destroyed with its Task
+class Task
+{
+  public:
+    struct promise_type
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                handle.promise().finished.store(true, std::memory_order_release);
+            }
+            void await_resume() const noexcept {}
+        };
+
+        Task get_return_object()
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+
+        std::atomic<bool> finished{false};
+        std::exception_ptr error;
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    Task(const Task&) = delete;
+    ~Task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    [[nodiscard]] bool finished() const
+    {
+        return m_handle.promise().finished.load(std::memory_order_acquire);
+    }
+
+    //! Rethrow the exception that escaped the coroutine, if any
+    void get() const
+    {
+        if (m_handle.promise().error)
+        {
+            std::rethrow_exception(m_handle.promise().error);
+        }
+    }
+
+  private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+Task increment(rmx::AsyncMutex<int>& mutex)
+{
+    auto value = co_await mutex.lock();
+    *value += 1;
+}
+
+Task increment_and_throw(rmx::AsyncMutex<int>& mutex)
+{
+    auto value = co_await mutex.lock();
+    *value += 1;
+    throw std::logic_error("Throwing an exception while the Mutex is locked");
+}
+
+Task read(const rmx::AsyncRwLock<int>& lock, int& out)
+{
+    auto value = co_await lock.lock();
+    out = *value;
+}
+
+Task write(rmx::AsyncRwLock<int>& lock, int value)
+{
+    auto guard = co_await lock.lock();
+    *guard = value;
+}
+
+Task increment_both(rmx::AsyncMutex<int>& mutex, rmx::Mutex<int>& other)
+{
+    auto value = co_await mutex.lock_unchecked();
+    *value += 1;
+    *other.lock() += 1;
+}
+
+void wait_for(const Task& task)
+{
+    while (!task.finished())
+    {
+        std::this_thread::yield();
+    }
+}
+}  // namespace
+
+TEST_CASE("Coroutines suspend while the AsyncMutex is locked")
+{
+    auto mutex = rmx::AsyncMutex<int>(0);
+
+    auto guard = mutex.try_lock();
+    REQUIRE(guard.has_value());
+
+    Task first = increment(mutex);
+    Task second = increment(mutex);
+    REQUIRE_FALSE(first.finished());
+    REQUIRE_FALSE(second.finished());
+
+    INFO("Releasing the guard resumes the waiters in order, on this thread");
+    **guard = 10;
+    guard.reset();
+    REQUIRE(first.finished());
+    REQUIRE(second.finished());
+    REQUIRE(**mutex.try_lock() == 12);
+}
+
+TEST_CASE("Exceptions in coroutines poison the AsyncMutex")
+{
+    auto mutex = rmx::AsyncMutex<int>(0);
+
+    Task throws = increment_and_throw(mutex);
+    REQUIRE(throws.finished());
+    REQUIRE_THROWS_AS(throws.get(), std::logic_error);
+    REQUIRE(mutex.is_poisoned());
+
+    Task poisoned = increment(mutex);
+    REQUIRE(poisoned.finished());
+    REQUIRE_THROWS_AS(poisoned.get(), std::runtime_error);
+    REQUIRE_THROWS_AS(mutex.try_lock(), std::runtime_error);
+
+    INFO("A poisoned AsyncMutex isn't left locked");
+    mutex.clear_poison();
+    Task recovered = increment(mutex);
+    REQUIRE(recovered.finished());
+    REQUIRE(**mutex.try_lock() == 2);
+}
+
+TEST_CASE("AsyncMutex hands the lock between threads")
+{
+    constexpr int threads = 4;
+    constexpr int iterations = 1000;
+    auto mutex = rmx::AsyncMutex<int>(0);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&mutex] {
+            std::vector<Task> tasks;
+            for (int i = 0; i < iterations; i++)
+            {
+                tasks.push_back(increment(mutex));
+            }
+            // Suspended coroutines are resumed by whichever thread unlocks the mutex
+            for (const Task& task : tasks)
+            {
+                wait_for(task);
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    REQUIRE(**mutex.try_lock() == threads * iterations);
+}
+
+TEST_CASE("AsyncRwLock readers share the lock, and writers exclude them")
+{
+    auto lock = rmx::AsyncRwLock<int>(1);
+    const auto& shared = std::as_const(lock);
+
+    auto reader = shared.try_lock();
+    REQUIRE(reader.has_value());
+
+    int first = 0;
+    Task concurrent_read = read(shared, first);
+    REQUIRE(concurrent_read.finished());
+    REQUIRE(first == 1);
+
+    Task writer = write(lock, 2);
+    REQUIRE_FALSE(writer.finished());
+
+    INFO("Readers queue behind a waiting writer");
+    int second = 0;
+    Task queued_read = read(shared, second);
+    REQUIRE_FALSE(queued_read.finished());
+    REQUIRE_FALSE(lock.try_lock().has_value());
+
+    reader.reset();
+    REQUIRE(writer.finished());
+    REQUIRE(queued_read.finished());
+    REQUIRE(second == 2);
+}
+
+TEST_CASE("Only writers poison the AsyncRwLock")
+{
+    auto lock = rmx::AsyncRwLock<int>(1);
+
+    try
+    {
+        auto reader = std::as_const(lock).try_lock();
+        throw std::runtime_error("Throwing an exception while the lock is held for reading");
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE_FALSE(lock.is_poisoned());
+
+    try
+    {
+        auto writer = lock.try_lock();
+        throw std::runtime_error("Throwing an exception while the lock is held for writing");
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE(lock.is_poisoned());
+
+    int value = 0;
+    Task poisoned = read(lock, value);
+    REQUIRE_THROWS_AS(poisoned.get(), std::runtime_error);
+}
+
+TEST_CASE("Waiters resumed by an exception don't poison the locks they take")
+{
+    SECTION("A reader throwing hands the AsyncRwLock to a writer")
+    {
+        auto lock = rmx::AsyncRwLock<int>(1);
+        std::optional<Task> writer;
+        try
+        {
+            auto reader = std::as_const(lock).try_lock();
+            writer.emplace(write(lock, 2));
+            REQUIRE_FALSE(writer->finished());
+            throw std::runtime_error("Throwing an exception while the lock is held for reading");
+        } catch (const std::runtime_error&)
+        {
+            // ...
+        }
+
+        INFO("The writer ran on this thread, while the exception was unwinding");
+        REQUIRE(writer->finished());
+        REQUIRE_NOTHROW(writer->get());
+        REQUIRE_FALSE(lock.is_poisoned());
+        REQUIRE(**lock.try_lock() == 2);
+    }
+
+    SECTION("A throwing AsyncMutex holder resumes a waiter that locks another Mutex")
+    {
+        auto mutex = rmx::AsyncMutex<int>(0);
+        auto other = rmx::Mutex<int>(0);
+        std::optional<Task> waiter;
+        try
+        {
+            auto guard = mutex.try_lock();
+            waiter.emplace(increment_both(mutex, other));
+            REQUIRE_FALSE(waiter->finished());
+            throw std::runtime_error("Throwing an exception while the AsyncMutex is locked");
+        } catch (const std::runtime_error&)
+        {
+            // ...
+        }
+
+        INFO("The waiter ran on this thread, while the exception was unwinding");
+        REQUIRE(waiter->finished());
+        REQUIRE_NOTHROW(waiter->get());
+        REQUIRE(mutex.is_poisoned());
+        REQUIRE_FALSE(other.is_poisoned());
+        REQUIRE(*other.lock() == 1);
+    }
+}
+
+TEST_CASE("A long queue of AsyncMutex waiters is resumed without nesting a frame per waiter")
+{
+    constexpr int waiters = 100000;
+    auto mutex = rmx::AsyncMutex<int>(0);
+
+    auto guard = mutex.try_lock();
+    std::vector<Task> tasks;
+    tasks.reserve(waiters);
+    for (int i = 0; i < waiters; i++)
+    {
+        tasks.push_back(increment(mutex));
+    }
+
+    // Each waiter releases the lock to the next one, which would overflow the stack if it were
+    // resumed from inside the previous waiter
+    guard.reset();
+    int finished = 0;
+    for (const Task& task : tasks)
+    {
+        finished += task.finished() ? 1 : 0;
+    }
+    REQUIRE(finished == waiters);
+    REQUIRE(**mutex.try_lock() == waiters);
+}
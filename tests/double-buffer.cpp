@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/double_buffer.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("The consumer swaps out everything the producers wrote")
+{
+    constexpr int producers = 4;
+    constexpr int samples = 5000;
+    rmx::DoubleBuffer<std::vector<int>> buffer;
+    std::atomic<int> finished{0};
+
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; p++)
+    {
+        pool.emplace_back([&buffer, &finished] {
+            for (int i = 0; i < samples; i++)
+            {
+                buffer.lock()->push_back(i);
+            }
+            finished++;
+        });
+    }
+
+    std::size_t consumed = 0;
+    std::vector<int> batch;
+    while (finished.load() < producers)
+    {
+        buffer.swap(batch);
+        consumed += batch.size();
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    buffer.swap(batch);
+    consumed += batch.size();
+
+    REQUIRE(consumed == producers * samples);
+    REQUIRE(buffer.lock()->empty());
+}
+
+TEST_CASE("Swapped buffers keep their capacity")
+{
+    rmx::DoubleBuffer<std::vector<int>> buffer;
+
+    std::vector<int> spare;
+    spare.reserve(1024);
+    spare.push_back(1);
+    const int* allocation = spare.data();
+
+    buffer.with([](std::vector<int>& active) { active.push_back(2); });
+    buffer.swap(spare);
+    REQUIRE(spare == std::vector<int>{2});
+
+    INFO("The spare was cleared, and its allocation reused for the active buffer");
+    auto active = buffer.lock();
+    REQUIRE(active->empty());
+    REQUIRE(active->capacity() >= 1024);
+    REQUIRE(active->data() == allocation);
+}
+
+TEST_CASE("Take the active buffer")
+{
+    rmx::DoubleBuffer<std::vector<int>> buffer;
+    buffer.lock()->push_back(1);
+
+    REQUIRE(buffer.take() == std::vector<int>{1});
+    REQUIRE(buffer.take().empty());
+}
+
+TEST_CASE("A producer exception poisons the DoubleBuffer")
+{
+    rmx::DoubleBuffer<std::vector<int>> buffer;
+
+    try
+    {
+        auto active = buffer.lock();
+        active->push_back(1);
+        throw std::runtime_error("Throwing an exception while the DoubleBuffer is locked");
+    } catch (...)
+    {
+        // ...
+    }
+
+    std::vector<int> batch;
+    REQUIRE(buffer.is_poisoned());
+    REQUIRE_THROWS_AS(buffer.swap(batch), std::runtime_error);
+    buffer.swap_unchecked(batch);
+    REQUIRE(batch == std::vector<int>{1});
+    buffer.clear_poison();
+    REQUIRE(buffer.take().empty());
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Exclusive access without locking")
+{
+    std::vector<rmx::Mutex<int>> mutexes(16);
+
+    {
+        INFO("get_mut() provides mutable access during initialization");
+        for (auto& mutex : mutexes)
+        {
+            mutex.get_mut() = 42;
+        }
+        auto value = mutexes.front().lock();
+        REQUIRE(*value == 42);
+    }
+
+    {
+        INFO("get_mut() doesn't lock the mutex");
+        auto& mutex = mutexes.back();
+        auto value = mutex.lock();
+        REQUIRE(mutex.get_mut_unchecked() == 42);
+    }
+}
+
+TEST_CASE("Move the value out of a Mutex")
+{
+    auto mutex = rmx::Mutex<std::string>("hello");
+    std::string value = std::move(mutex).into_inner();
+    REQUIRE(value == "hello");
+}
+
+TEST_CASE("Recover from poisoning")
+{
+    auto mutex = rmx::Mutex(1);
+
+    try
+    {
+        auto value = mutex.lock();
+        *value = 2;
+        throw std::runtime_error("Throwing an exception while the Mutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+
+    REQUIRE(mutex.is_poisoned());
+    REQUIRE_THROWS(mutex.get_mut());
+
+    {
+        INFO("Unchecked access still works");
+        REQUIRE(mutex.get_mut_unchecked() == 2);
+    }
+
+    {
+        INFO("Clearing the poison makes the Mutex usable again");
+        mutex.get_mut_unchecked() = 1;
+        mutex.clear_poison();
+        REQUIRE_FALSE(mutex.is_poisoned());
+        auto value = mutex.lock();
+        REQUIRE(*value == 1);
+    }
+
+    {
+        INFO("into_inner() checks for poison");
+        auto poisoned = rmx::Mutex(3);
+        try
+        {
+            auto value = poisoned.lock();
+            throw std::runtime_error("Throwing an exception while the Mutex is locked");
+        } catch (...)
+        {
+            // ...
+        }
+        REQUIRE_THROWS(std::move(poisoned).into_inner());
+        REQUIRE(std::move(poisoned).into_inner_unchecked() == 3);
+    }
+}
@@ -0,0 +1,69 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace {
+constexpr std::size_t cache_line = rmx::hardware_destructive_interference_size;
+
+//! The layout of a Mutex without any layout policy
+struct Unpadded
+{
+    std::mutex mutex;
+    int value;
+    bool was_poisoned;
+};
+
+using Big = std::array<char, 100>;
+
+std::ptrdiff_t byte_distance(const void* a, const void* b)
+{
+    return reinterpret_cast<const std::byte*>(b) - reinterpret_cast<const std::byte*>(a);
+}
+}  // namespace
+
+TEST_CASE("Compact layout adds no padding")
+{
+    STATIC_REQUIRE(sizeof(rmx::Mutex<int>) == sizeof(Unpadded));
+    STATIC_REQUIRE(alignof(rmx::Mutex<int>) == alignof(Unpadded));
+}
+
+TEST_CASE("CachePadded layout pads to a cache line")
+{
+    using Padded = rmx::Mutex<int, std::mutex, rmx::CachePadded>;
+    STATIC_REQUIRE(sizeof(Padded) == cache_line);
+    STATIC_REQUIRE(alignof(Padded) == cache_line);
+    STATIC_REQUIRE(sizeof(rmx::Mutex<Big, std::mutex, rmx::CachePadded>) == 3 * cache_line);
+
+    INFO("Adjacent Mutexes in an array are on separate cache lines");
+    std::array<Padded, 2> mutexes;
+    REQUIRE(byte_distance(&mutexes[0], &mutexes[1]) == static_cast<std::ptrdiff_t>(cache_line));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&mutexes[0]) % cache_line == 0);
+}
+
+TEST_CASE("Colocated layout fits in one cache line")
+{
+    using Colocated = rmx::Mutex<std::int64_t, std::mutex, rmx::Colocated>;
+    STATIC_REQUIRE(sizeof(Colocated) == cache_line);
+    STATIC_REQUIRE(alignof(Colocated) == cache_line);
+
+    Colocated mutex(42);
+    auto value = mutex.lock();
+    REQUIRE(*value == 42);
+    REQUIRE(byte_distance(&mutex, &*value) < static_cast<std::ptrdiff_t>(cache_line));
+}
+
+TEST_CASE("Split layout separates the lock and value")
+{
+    using Split = rmx::Mutex<int, std::mutex, rmx::Split>;
+    STATIC_REQUIRE(sizeof(Split) == 2 * cache_line);
+    STATIC_REQUIRE(sizeof(rmx::Mutex<Big, std::mutex, rmx::Split>) == 3 * cache_line);
+
+    Split mutex(42);
+    auto value = mutex.lock();
+    REQUIRE(*value == 42);
+    REQUIRE(byte_distance(&mutex, &*value) == static_cast<std::ptrdiff_t>(cache_line));
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/left_right.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+//! A value whose copy assignment fails on demand
+struct Fragile
+{
+    Fragile() = default;
+    Fragile(const Fragile&) = default;
+    Fragile& operator=(const Fragile& other)
+    {
+        if (fail_copies)
+        {
+            throw std::runtime_error("Failed to copy");
+        }
+        value = other.value;
+        return *this;
+    }
+
+    static inline bool fail_copies = false;
+    int value = 0;
+};
+}  // namespace
+
+TEST_CASE("Writes are applied to both copies")
+{
+    auto left_right = rmx::LeftRight<std::vector<int>>({1, 2, 3});
+
+    left_right.write([](std::vector<int>& v) { v.push_back(4); });
+    REQUIRE(*left_right.read() == std::vector<int>{1, 2, 3, 4});
+    const std::size_t size = left_right.write([](std::vector<int>& v) {
+        v.push_back(5);
+        return v.size();
+    });
+    REQUIRE(size == 5);
+    REQUIRE(left_right.read()->size() == 5);
+}
+
+TEST_CASE("Readers always see a consistent copy")
+{
+    auto left_right = rmx::LeftRight<std::pair<int, int>>(0, 0);
+    std::atomic<bool> done{false};
+    std::atomic<bool> consistent{true};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; t++)
+    {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load())
+            {
+                auto value = left_right.read();
+                // Writes are never undone, so each reader sees them in order
+                if (value->first != value->second || value->first < last)
+                {
+                    consistent = false;
+                }
+                last = value->first;
+            }
+        });
+    }
+
+    for (int i = 1; i <= 2000; i++)
+    {
+        left_right.write([i](std::pair<int, int>& value) {
+            value.first = i;
+            value.second = i;
+        });
+    }
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    REQUIRE(consistent);
+    REQUIRE(left_right.read()->first == 2000);
+}
+
+TEST_CASE("A failed write is rolled back from the other copy")
+{
+    auto left_right = rmx::LeftRight<std::vector<int>>({1, 2, 3});
+
+    auto clear_and_throw = [](std::vector<int>& v) {
+        v.clear();
+        throw std::logic_error("oops");
+    };
+    REQUIRE_THROWS_AS(left_right.write(clear_and_throw), std::logic_error);
+    REQUIRE_FALSE(left_right.is_poisoned());
+
+    INFO("Both copies are intact");
+    REQUIRE(*left_right.read() == std::vector<int>{1, 2, 3});
+    left_right.write([](std::vector<int>&) {});
+    REQUIRE(*left_right.read() == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("A write that fails on the second copy takes effect")
+{
+    auto left_right = rmx::LeftRight<std::vector<int>>({1, 2, 3});
+
+    int applied = 0;
+    auto append_and_throw_second = [&applied](std::vector<int>& v) {
+        v.push_back(4);
+        if (++applied == 2)
+        {
+            throw std::logic_error("oops");
+        }
+    };
+    REQUIRE_THROWS_AS(left_right.write(append_and_throw_second), std::logic_error);
+    REQUIRE_FALSE(left_right.is_poisoned());
+
+    INFO("Both copies hold the result of the first application");
+    REQUIRE(*left_right.read() == std::vector<int>{1, 2, 3, 4});
+    left_right.write([](std::vector<int>&) {});
+    REQUIRE(*left_right.read() == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("A write that can't be rolled back poisons the LeftRight")
+{
+    auto left_right = rmx::LeftRight<Fragile>();
+
+    Fragile::fail_copies = true;
+    auto modify_and_throw = [](Fragile& f) {
+        f.value = 1;
+        throw std::logic_error("oops");
+    };
+    REQUIRE_THROWS_AS(left_right.write(modify_and_throw), std::logic_error);
+    Fragile::fail_copies = false;
+
+    REQUIRE(left_right.is_poisoned());
+    REQUIRE_THROWS_AS(left_right.read(), std::runtime_error);
+    INFO("The readable copy is still intact");
+    REQUIRE(left_right.read_unchecked()->value == 0);
+    REQUIRE_THROWS_AS(left_right.write([](Fragile&) {}), std::runtime_error);
+
+    left_right.write_unchecked([](Fragile& f) { f.value = 2; });
+    left_right.clear_poison();
+    REQUIRE(left_right.read()->value == 2);
+}
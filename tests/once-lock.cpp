@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/once.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("OnceLock initializes its value once")
+{
+    constexpr int threads = 8;
+    rmx::OnceLock<std::string> once;
+    std::atomic<int> initializations{0};
+    std::vector<const std::string*> seen(threads);
+
+    REQUIRE(once.get() == nullptr);
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&, t] {
+            seen[t] = &once.get_or_init([&initializations] {
+                initializations++;
+                // Give the other threads time to find the initialization in progress
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return std::string("hello");
+            });
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    REQUIRE(initializations == 1);
+    REQUIRE(once.get() != nullptr);
+    REQUIRE(*once.get() == "hello");
+    for (const std::string* value : seen)
+    {
+        REQUIRE(value == once.get());
+    }
+}
+
+TEST_CASE("OnceLock can be set once")
+{
+    rmx::OnceLock<int> once;
+
+    REQUIRE(once.set(1));
+    REQUIRE_FALSE(once.set(2));
+    REQUIRE(once.get_or_init([] { return 3; }) == 1);
+}
+
+TEST_CASE("Failed initialization poisons the OnceLock")
+{
+    rmx::OnceLock<int> once;
+
+    REQUIRE_THROWS_AS(once.get_or_init([]() -> int { throw std::logic_error("oops"); }),
+                      std::logic_error);
+    REQUIRE(once.is_poisoned());
+    REQUIRE(once.get() == nullptr);
+    REQUIRE_THROWS_AS(once.get_or_init([] { return 1; }), std::runtime_error);
+    REQUIRE_THROWS_AS(once.set(1), std::runtime_error);
+
+    INFO("Clearing the poison allows another attempt");
+    once.clear_poison();
+    REQUIRE(once.get_or_init([] { return 2; }) == 2);
+}
+
+TEST_CASE("LazyLock initializes its value on first access")
+{
+    int initializations = 0;
+    rmx::LazyLock lazy([&initializations] {
+        initializations++;
+        return std::string("hello");
+    });
+
+    REQUIRE(lazy.get() == nullptr);
+    REQUIRE(initializations == 0);
+    REQUIRE(*lazy == "hello");
+    REQUIRE(lazy->size() == 5);
+    REQUIRE(initializations == 1);
+}
+
+TEST_CASE("Failed initialization poisons the LazyLock")
+{
+    bool fail = true;
+    rmx::LazyLock lazy([&fail] {
+        if (fail)
+        {
+            throw std::logic_error("oops");
+        }
+        return 42;
+    });
+
+    REQUIRE_THROWS_AS(lazy.force(), std::logic_error);
+    REQUIRE(lazy.is_poisoned());
+    REQUIRE_THROWS_AS(lazy.force(), std::runtime_error);
+
+    fail = false;
+    lazy.clear_poison();
+    REQUIRE(*lazy == 42);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/oneshot.hpp>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Send a value to a waiting receiver")
+{
+    auto [sender, receiver] = rmx::Oneshot<std::string>::make();
+
+    bool sent = false;
+    std::thread thread([sender = std::move(sender), &sent]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sent = sender.send("reply");
+    });
+    REQUIRE(receiver.recv() == "reply");
+    thread.join();
+    REQUIRE(sent);
+
+    REQUIRE_THROWS_AS(receiver.try_recv(), std::logic_error);
+}
+
+TEST_CASE("Receive without waiting")
+{
+    rmx::Oneshot<int> storage;
+    auto [sender, receiver] = storage.split();
+
+    REQUIRE(receiver.try_recv() == std::nullopt);
+    REQUIRE(sender.send(1));
+    REQUIRE_THROWS_AS(sender.send(2), std::logic_error);
+    REQUIRE(receiver.try_recv() == 1);
+}
+
+TEST_CASE("Receiving times out if nothing is sent")
+{
+    auto [sender, receiver] = rmx::Oneshot<int>::make();
+
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(receiver.recv_for(std::chrono::milliseconds(20)) == std::nullopt);
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+    sender.send(1);
+    REQUIRE(receiver.recv_for(std::chrono::milliseconds(20)) == 1);
+}
+
+TEST_CASE("Dropping the sender without sending wakes the receiver")
+{
+    auto [sender, receiver] = rmx::Oneshot<int>::make();
+
+    std::thread thread([sender = std::move(sender)]() mutable {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        try
+        {
+            auto dropped = std::move(sender);
+            throw std::runtime_error("Throwing an exception before sending");
+        } catch (...)
+        {
+            // ...
+        }
+    });
+    REQUIRE_THROWS_AS(receiver.recv(), std::runtime_error);
+    REQUIRE(receiver.is_sender_dropped());
+    thread.join();
+}
+
+TEST_CASE("Senders can tell when the receiver was dropped")
+{
+    auto value = std::make_shared<int>(1);
+    {
+        auto [sender, receiver] = rmx::Oneshot<std::shared_ptr<int>>::make();
+        {
+            auto dropped = std::move(receiver);
+        }
+        REQUIRE(sender.is_receiver_dropped());
+        REQUIRE_FALSE(sender.send(value));
+    }
+    REQUIRE(value.use_count() == 1);
+
+    {
+        rmx::Oneshot<std::shared_ptr<int>> storage;
+        auto [sender, receiver] = storage.split();
+        sender.send(value);
+        REQUIRE(value.use_count() == 2);
+    }
+    INFO("A value that was never received is destroyed with the Oneshot");
+    REQUIRE(value.use_count() == 1);
+}
+
+TEST_CASE("Many concurrent oneshots")
+{
+    constexpr int requests = 2000;
+    std::vector<rmx::Oneshot<int>::Receiver> receivers;
+    std::vector<rmx::Oneshot<int>::Sender> senders;
+    for (int i = 0; i < requests; i++)
+    {
+        auto [sender, receiver] = rmx::Oneshot<int>::make();
+        senders.push_back(std::move(sender));
+        receivers.push_back(std::move(receiver));
+    }
+
+    std::thread responder([&senders] {
+        for (int i = 0; i < requests; i++)
+        {
+            senders[i].send(i);
+        }
+    });
+    long total = 0;
+    for (auto& receiver : receivers)
+    {
+        total += receiver.recv();
+    }
+    responder.join();
+
+    REQUIRE(total == long{requests} * (requests - 1) / 2);
+}
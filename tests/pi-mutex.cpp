@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/pthread.hpp>
+#include <rmx/rmx.hpp>
+#include <sched.h>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("Priority-inheritance mutex")
+{
+    rmx::Mutex<int, rmx::PiMutex> mutex(0);
+
+    {
+        INFO("try_lock() fails if already locked");
+        auto value = mutex.lock();
+        REQUIRE_FALSE(mutex.try_lock().has_value());
+    }
+
+    {
+        INFO("Provides mutual exclusion");
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+        {
+            threads.emplace_back([&mutex] {
+                for (int j = 0; j < 1000; j++)
+                {
+                    auto value = mutex.lock();
+                    *value += 1;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        auto value = mutex.lock();
+        REQUIRE(*value == 4000);
+    }
+}
+
+TEST_CASE("Priority-ceiling mutex")
+{
+    rmx::CeilingMutex<10> ceiling;
+
+    int actual = 0;
+    REQUIRE(pthread_mutex_getprioceiling(ceiling.native_handle(), &actual) == 0);
+    REQUIRE(actual == rmx::CeilingMutex<10>::priority_ceiling());
+
+    int sched_error = 0;
+    bool locked = false;
+    bool relocked = false;
+    std::thread realtime([&] {
+        sched_param param{};
+        param.sched_priority = 1;
+        sched_error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (sched_error != 0)
+        {
+            return;
+        }
+
+        ceiling.lock();
+        locked = !ceiling.try_lock();
+        ceiling.unlock();
+        relocked = ceiling.try_lock();
+        ceiling.unlock();
+    });
+    realtime.join();
+
+    if (sched_error != 0)
+    {
+        SKIP("Insufficient privileges to create a SCHED_FIFO thread");
+    }
+    REQUIRE(locked);
+    REQUIRE(relocked);
+}
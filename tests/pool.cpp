@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Objects are returned to the pool when their guard is dropped")
+{
+    rmx::Pool<std::string> pool({"first", "second"});
+    REQUIRE(pool.size() == 2);
+
+    {
+        auto a = pool.acquire();
+        auto b = pool.acquire();
+        REQUIRE(std::set<std::string>{*a, *b} == std::set<std::string>{"first", "second"});
+        REQUIRE(pool.available() == 0);
+        REQUIRE_FALSE(pool.try_acquire());
+        REQUIRE_FALSE(pool.try_acquire_for(std::chrono::milliseconds(10)));
+        a->append("!");
+        b->append("!");
+    }
+
+    REQUIRE(pool.available() == 2);
+    auto a = pool.acquire();
+    auto b = pool.try_acquire();
+    REQUIRE(b);
+    REQUIRE(std::set<std::string>{*a, **b} == std::set<std::string>{"first!", "second!"});
+}
+
+TEST_CASE("Acquiring waits for an object to be returned")
+{
+    rmx::Pool<int> pool({1});
+    std::atomic<bool> acquired{false};
+    int value = 0;
+    std::thread waiter;
+
+    {
+        auto held = pool.acquire();
+        waiter = std::thread([&] {
+            value = *pool.acquire();
+            acquired = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE_FALSE(acquired);
+    }
+    waiter.join();
+    REQUIRE(acquired);
+    REQUIRE(value == 1);
+}
+
+TEST_CASE("Each object is checked out by one thread at a time")
+{
+    constexpr int objects = 4;
+    constexpr int threads = 8;
+    constexpr int checkouts = 2000;
+    rmx::Pool<int> pool({0, 1, 2, 3});
+    std::vector<std::atomic<int>> holders(objects);
+    std::atomic<bool> overlapped{false};
+    std::atomic<int> completed{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&] {
+            for (int i = 0; i < checkouts; i++)
+            {
+                auto object = pool.acquire();
+                if (holders[*object]++ != 0)
+                {
+                    overlapped = true;
+                }
+                holders[*object]--;
+                completed++;
+            }
+        });
+    }
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    REQUIRE_FALSE(overlapped);
+    REQUIRE(completed == threads * checkouts);
+    REQUIRE(pool.available() == objects);
+}
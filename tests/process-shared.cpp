@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/process.hpp>
+#include <rmx/rmx.hpp>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace {
+//! Construct a @p T in an anonymous shared memory segment that's inherited across fork()
+template<typename T, typename... ArgsT>
+T* make_shared(ArgsT&&... args)
+{
+    void* segment =
+        mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    REQUIRE(segment != MAP_FAILED);
+    return new (segment) T(std::forward<ArgsT>(args)...);
+}
+
+template<typename T>
+void destroy_shared(T* object)
+{
+    object->~T();
+    munmap(object, sizeof(T));
+}
+
+//! Run the given function in a child process
+template<typename FunctionT>
+pid_t spawn(FunctionT&& function)
+{
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        _exit(function() ? 0 : 1);
+    }
+    return pid;
+}
+
+bool succeeded(pid_t pid)
+{
+    int status = 0;
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+struct Pair
+{
+    std::uint64_t first;
+    std::uint64_t second;
+    std::uint32_t third;
+};
+}  // namespace
+
+TEST_CASE("Process-shared reader/writer lock")
+{
+    using Table = rmx::Mutex<std::int64_t, rmx::ProcessRwMutex>;
+    Table* table = make_shared<Table>(0);
+    const Table& readonly = *table;
+
+    {
+        INFO("Readers don't block each other");
+        auto reader1 = readonly.lock();
+        auto reader2 = readonly.try_lock();
+        REQUIRE(reader2.has_value());
+        REQUIRE_FALSE(table->try_lock().has_value());
+    }
+
+    {
+        INFO("Writers block readers");
+        auto writer = table->lock();
+        REQUIRE_FALSE(readonly.try_lock().has_value());
+        REQUIRE_FALSE(table->try_lock().has_value());
+    }
+
+    {
+        INFO("Readers and writers in different processes are synchronized");
+        std::vector<pid_t> children;
+        for (int i = 0; i < 2; i++)
+        {
+            children.push_back(spawn([table] {
+                for (int j = 0; j < 1000; j++)
+                {
+                    auto value = table->lock();
+                    *value += 1;
+                }
+                return true;
+            }));
+            children.push_back(spawn([&readonly] {
+                std::int64_t last = 0;
+                for (int j = 0; j < 1000; j++)
+                {
+                    auto value = readonly.lock();
+                    if (*value < last)
+                    {
+                        return false;
+                    }
+                    last = *value;
+                }
+                return true;
+            }));
+        }
+        for (pid_t child : children)
+        {
+            REQUIRE(succeeded(child));
+        }
+
+        auto value = readonly.lock();
+        REQUIRE(*value == 2000);
+    }
+
+    destroy_shared(table);
+}
+
+TEST_CASE("Process-shared sequence lock")
+{
+    using SeqLock = rmx::ProcessSeqLock<Pair>;
+    SeqLock* seqlock = make_shared<SeqLock>(Pair{1, 1, 1});
+
+    {
+        INFO("Readers see the initial value");
+        const Pair value = seqlock->read();
+        REQUIRE(value.first == 1);
+        REQUIRE(value.third == 1);
+    }
+
+    {
+        INFO("Write guards publish on scope exit");
+        {
+            auto writer = seqlock->write();
+            writer->first = 2;
+            writer->second = 2;
+            REQUIRE_FALSE(seqlock->try_read().has_value());
+            REQUIRE_FALSE(seqlock->try_write().has_value());
+        }
+        REQUIRE(seqlock->read().second == 2);
+    }
+
+    {
+        INFO("Write guards discard the write on exceptions");
+        try
+        {
+            auto writer = seqlock->write();
+            writer->first = 3;
+            throw std::runtime_error("Throwing an exception while writing");
+        } catch (...)
+        {
+            // ...
+        }
+        REQUIRE(seqlock->read().first == 2);
+    }
+
+    {
+        INFO("Readers in other processes never see torn writes");
+        const pid_t writer = spawn([seqlock] {
+            for (std::uint64_t i = 0; i < 10000; i++)
+            {
+                seqlock->store(Pair{i, i, static_cast<std::uint32_t>(i)});
+            }
+            return true;
+        });
+        const pid_t reader = spawn([seqlock] {
+            for (int i = 0; i < 10000; i++)
+            {
+                const Pair value = seqlock->read();
+                if (value.first != value.second || value.first != value.third)
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+        REQUIRE(succeeded(writer));
+        REQUIRE(succeeded(reader));
+        REQUIRE(seqlock->read().first == 9999);
+    }
+
+    destroy_shared(seqlock);
+}
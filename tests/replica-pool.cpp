@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/replica_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Every replica is constructed from the same args")
+{
+    const std::string initial = "scratch";
+    rmx::ReplicaPool<std::string, 3> pool(initial);
+    REQUIRE(pool.size() == 3);
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(*pool.lock() == initial);
+    }
+}
+
+TEST_CASE("Concurrent lockers get different replicas")
+{
+    rmx::ReplicaPool<int, 3> pool;
+    auto first = pool.lock();
+    auto second = pool.lock();
+    auto third = pool.lock();
+    REQUIRE(std::set<int*>{&*first, &*second, &*third}.size() == 3);
+    REQUIRE_FALSE(pool.try_lock());
+}
+
+TEST_CASE("A thread keeps using the same replica while it's free")
+{
+    rmx::ReplicaPool<int, 4> pool;
+    int* used = nullptr;
+    {
+        auto guard = pool.lock();
+        used = &*guard;
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        REQUIRE(&*pool.lock() == used);
+    }
+}
+
+TEST_CASE("Locking waits when every replica is busy")
+{
+    rmx::ReplicaPool<int, 2> pool;
+    std::atomic<bool> locked{false};
+    std::thread waiter;
+
+    {
+        auto first = pool.lock();
+        auto second = pool.lock();
+        waiter = std::thread([&] {
+            *pool.lock() += 1;
+            locked = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE_FALSE(locked);
+    }
+    waiter.join();
+    REQUIRE(locked);
+}
+
+TEST_CASE("Poisoned replicas are taken out of service")
+{
+    rmx::ReplicaPool<int, 2> pool;
+    int* poisoned = nullptr;
+    try
+    {
+        auto guard = pool.lock();
+        poisoned = &*guard;
+        throw std::runtime_error("Throwing an exception while a replica is locked");
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE(pool.poisoned() == 1);
+
+    for (int i = 0; i < 4; i++)
+    {
+        REQUIRE(&*pool.lock() != poisoned);
+    }
+
+    try
+    {
+        pool.with([](int&) {
+            throw std::runtime_error("Throwing an exception while a replica is locked");
+        });
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE(pool.poisoned() == 2);
+    REQUIRE_THROWS_AS(pool.lock(), std::runtime_error);
+    REQUIRE_THROWS_AS(pool.try_lock(), std::runtime_error);
+    *pool.lock_unchecked() = 1;
+
+    pool.clear_poison();
+    REQUIRE(pool.poisoned() == 0);
+    auto first = pool.lock();
+    auto second = pool.lock();
+}
+
+TEST_CASE("Many threads share a few replicas")
+{
+    constexpr int threads = 8;
+    constexpr int iterations = 2000;
+    rmx::ReplicaPool<long, 3> pool;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&pool] {
+            for (int i = 0; i < iterations; i++)
+            {
+                *pool.lock() += 1;
+            }
+        });
+    }
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    long total = 0;
+    auto first = pool.lock();
+    auto second = pool.lock();
+    auto third = pool.lock();
+    total = *first + *second + *third;
+    REQUIRE(total == threads * iterations);
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/pthread.hpp>
+#include <rmx/rmx.hpp>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <new>
+#include <thread>
+
+namespace {
+using SharedMutex = rmx::Mutex<int, rmx::RobustMutex>;
+
+//! Map an anonymous shared memory segment that's inherited across fork()
+SharedMutex* make_shared_mutex()
+{
+    void* segment = mmap(nullptr,
+                         sizeof(SharedMutex),
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_ANONYMOUS,
+                         -1,
+                         0);
+    REQUIRE(segment != MAP_FAILED);
+    return new (segment) SharedMutex(0);
+}
+
+void destroy_shared_mutex(SharedMutex* mutex)
+{
+    mutex->~SharedMutex();
+    munmap(mutex, sizeof(SharedMutex));
+}
+
+//! Run the given function in a child process, and wait for it to exit
+template<typename FunctionT>
+void in_child_process(FunctionT&& function)
+{
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (pid == 0)
+    {
+        function();
+        _exit(0);
+    }
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    REQUIRE(WIFEXITED(status));
+}
+}  // namespace
+
+TEST_CASE("Robust mutex shared between processes")
+{
+    SharedMutex* mutex = make_shared_mutex();
+
+    {
+        INFO("Processes see each other's changes");
+        in_child_process([mutex] {
+            for (int i = 0; i < 1000; i++)
+            {
+                auto value = mutex->lock();
+                *value += 1;
+            }
+        });
+        auto value = mutex->lock();
+        REQUIRE(*value == 1000);
+    }
+
+    {
+        INFO("A process dying while holding the lock poisons the Mutex");
+        in_child_process([mutex] {
+            auto value = mutex->lock();
+            *value = -1;
+            // Exit without running the guard's destructor
+            _exit(0);
+        });
+
+        REQUIRE_THROWS(mutex->lock());
+        REQUIRE(mutex->is_poisoned());
+
+        auto value = mutex->lock_unchecked();
+        REQUIRE(*value == -1);
+    }
+
+    {
+        INFO("The Mutex can be recovered after the owner died");
+        mutex->clear_poison();
+        auto value = mutex->lock();
+        *value = 0;
+    }
+
+    destroy_shared_mutex(mutex);
+}
+
+TEST_CASE("Robust mutex detects dead threads")
+{
+    SharedMutex mutex(0);
+
+    std::thread thread([&mutex] {
+        // Disown the pthread lock without unlocking it, so the thread exits while holding it
+        auto value = mutex.lock();
+        value.inner().release();
+    });
+    thread.join();
+
+    auto value = mutex.try_lock_unchecked();
+    REQUIRE(value.has_value());
+    REQUIRE(mutex.is_poisoned());
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/semaphore.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Semaphores count permits")
+{
+    rmx::Semaphore semaphore(2);
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE(semaphore.try_acquire());
+    REQUIRE_FALSE(semaphore.try_acquire());
+
+    semaphore.release(3);
+    REQUIRE(semaphore.available() == 3);
+    REQUIRE_FALSE(semaphore.try_acquire(4));
+    REQUIRE(semaphore.try_acquire(3));
+    REQUIRE(semaphore.available() == 0);
+}
+
+TEST_CASE("Acquiring waits for permits to be released")
+{
+    rmx::Semaphore semaphore;
+    std::atomic<bool> acquired{false};
+
+    std::thread waiter([&] {
+        semaphore.acquire(2);
+        acquired = true;
+    });
+    semaphore.release();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(acquired);
+
+    semaphore.release();
+    waiter.join();
+    REQUIRE(acquired);
+    REQUIRE(semaphore.available() == 0);
+}
+
+TEST_CASE("Acquiring times out")
+{
+    rmx::Semaphore semaphore(1);
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(semaphore.try_acquire_for(std::chrono::milliseconds(20), 2));
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+    REQUIRE(semaphore.try_acquire_for(std::chrono::milliseconds(20)));
+}
+
+TEST_CASE("A semaphore bounds concurrency")
+{
+    constexpr int limit = 3;
+    constexpr int threads = 8;
+    rmx::Semaphore semaphore(limit);
+    std::atomic<int> inside{0};
+    std::atomic<int> most{0};
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&] {
+            for (int i = 0; i < 1000; i++)
+            {
+                semaphore.acquire();
+                const int now = ++inside;
+                int seen = most.load();
+                while (now > seen && !most.compare_exchange_weak(seen, now))
+                {
+                }
+                inside--;
+                semaphore.release();
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    REQUIRE(most <= limit);
+    REQUIRE(semaphore.available() == limit);
+}
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/sharded.hpp>
+
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("Sharded mutex partitions keys")
+{
+    rmx::ShardedMutex<std::unordered_map<int, int>, 8> map;
+    STATIC_REQUIRE(decltype(map)::shard_count() == 8);
+
+    for (int key = 0; key < 100; key++)
+    {
+        auto shard = map.lock(key);
+        (*shard)[key] = key * 2;
+    }
+
+    {
+        INFO("Keys are found in the shard they hash to");
+        auto shard = map.lock(42);
+        REQUIRE(shard->at(42) == 84);
+    }
+
+    {
+        INFO("Keys are spread across the shards");
+        std::vector<std::size_t> sizes;
+        map.for_each_shard([&](const std::unordered_map<int, int>& shard) {
+            sizes.push_back(shard.size());
+        });
+        REQUIRE(sizes.size() == 8);
+        std::size_t total = 0;
+        for (const std::size_t size : sizes)
+        {
+            REQUIRE(size > 0);
+            total += size;
+        }
+        REQUIRE(total == 100);
+    }
+
+    {
+        INFO("Different shards can be locked at the same time");
+        const std::size_t first = map.shard_index(1);
+        int other = 2;
+        while (map.shard_index(other) == first)
+        {
+            other++;
+        }
+        auto shard1 = map.lock(1);
+        auto shard2 = map.try_lock(other);
+        REQUIRE(shard2.has_value());
+
+        INFO("But not the same shard");
+        int same = 2;
+        while (map.shard_index(same) != first)
+        {
+            same++;
+        }
+        REQUIRE_FALSE(map.try_lock(same).has_value());
+    }
+}
+
+TEST_CASE("Lock every shard")
+{
+    rmx::ShardedMutex<int, 4> counters(10);
+
+    {
+        auto shards = counters.lock_all();
+        int total = 0;
+        for (auto& shard : shards)
+        {
+            total += *shard;
+        }
+        REQUIRE(total == 40);
+
+        INFO("Every shard is locked");
+        for (std::size_t i = 0; i < counters.shard_count(); i++)
+        {
+            REQUIRE_FALSE(counters.shard(i).try_lock().has_value());
+        }
+    }
+
+    INFO("Every shard is unlocked afterwards");
+    for (std::size_t i = 0; i < counters.shard_count(); i++)
+    {
+        REQUIRE(counters.shard(i).try_lock().has_value());
+    }
+}
+
+TEST_CASE("Locking every shard with one poisoned doesn't poison the others")
+{
+    rmx::ShardedMutex<int, 4> counters(10);
+    try
+    {
+        auto shard = counters.shard(2).lock();
+        throw std::runtime_error("Throwing an exception while a shard is locked");
+    } catch (const std::runtime_error&)
+    {
+        // ...
+    }
+    REQUIRE(counters.shard(2).is_poisoned());
+
+    REQUIRE_THROWS_AS(counters.lock_all(), std::runtime_error);
+    for (std::size_t i = 0; i < counters.shard_count(); i++)
+    {
+        INFO("Shard " << i);
+        REQUIRE(counters.shard(i).is_poisoned() == (i == 2));
+        REQUIRE(counters.shard(i).try_lock_unchecked().has_value());
+    }
+}
+
+TEST_CASE("Concurrent sharded counters")
+{
+    rmx::ShardedMutex<int, 4> counters;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&counters, i] {
+            for (int j = 0; j < 1000; j++)
+            {
+                auto counter = counters.lock(i * 1000 + j);
+                *counter += 1;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    int total = 0;
+    counters.for_each_shard([&](int count) { total += count; });
+    REQUIRE(total == 4000);
+}
+
+TEST_CASE("Shared locking sharded mutex")
+{
+    rmx::ShardedMutex<std::string, 4, std::shared_mutex> names("rmx");
+    const auto& readonly = names;
+
+    auto reader1 = readonly.lock(1);
+    auto reader2 = readonly.lock(1);
+    REQUIRE(*reader1 == "rmx");
+    REQUIRE(*reader2 == "rmx");
+}
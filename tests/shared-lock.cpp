@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <shared_mutex>
+
+namespace {
+int read_value(const rmx::Mutex<int, std::shared_mutex>& mutex)
+{
+    auto value = mutex.lock();
+    return *value;
+}
+}  // namespace
+
+TEST_CASE("Shared locking from a const Mutex")
+{
+    rmx::Mutex<int, std::shared_mutex> mutex(42);
+    const auto& const_mutex = mutex;
+
+    {
+        INFO("Can read through a const reference");
+        REQUIRE(read_value(mutex) == 42);
+    }
+
+    {
+        INFO("Multiple readers can hold the lock at once");
+        auto reader1 = const_mutex.lock();
+        auto reader2 = const_mutex.try_lock();
+        REQUIRE(reader2.has_value());
+        REQUIRE(*reader1 == **reader2);
+    }
+
+    {
+        INFO("Writers are excluded by readers");
+        auto reader = const_mutex.lock();
+        auto writer = mutex.try_lock();
+        REQUIRE_FALSE(writer.has_value());
+    }
+
+    {
+        INFO("Readers are excluded by writers");
+        auto writer = mutex.lock();
+        *writer = 0;
+        auto reader = const_mutex.try_lock();
+        REQUIRE_FALSE(reader.has_value());
+    }
+
+    {
+        INFO("Exceptions while reading don't poison the Mutex");
+        try
+        {
+            auto reader = const_mutex.lock();
+            throw std::runtime_error("Throwing an exception while the Mutex is read locked");
+        } catch (...)
+        {
+            // ...
+        }
+        REQUIRE_FALSE(mutex.is_poisoned());
+        REQUIRE(read_value(mutex) == 0);
+    }
+
+    {
+        INFO("Readers check for poison");
+        try
+        {
+            auto writer = mutex.lock();
+            throw std::runtime_error("Throwing an exception while the Mutex is locked");
+        } catch (...)
+        {
+            // ...
+        }
+        REQUIRE_THROWS(read_value(mutex));
+        auto reader = const_mutex.lock_unchecked();
+        REQUIRE(*reader == 0);
+    }
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/strand.hpp>
+
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Posted closures run serially, in order")
+{
+    constexpr std::size_t threads = 4;
+    constexpr std::size_t iterations = 5000;
+    auto strand = rmx::Strand<std::vector<std::vector<std::size_t>>>(threads);
+
+    std::vector<std::thread> pool;
+    for (std::size_t t = 0; t < threads; t++)
+    {
+        pool.emplace_back([&strand, t] {
+            for (std::size_t i = 0; i < iterations; i++)
+            {
+                strand.post(
+                    [t, i](std::vector<std::vector<std::size_t>>& v) { v[t].push_back(i); });
+            }
+        });
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    INFO("Every closure has run once the posting threads have returned");
+    auto sequences = strand.submit([](std::vector<std::vector<std::size_t>>& v) { return v; });
+    for (const auto& sequence : sequences.get())
+    {
+        REQUIRE(sequence.size() == iterations);
+        for (std::size_t i = 0; i < iterations; i++)
+        {
+            REQUIRE(sequence[i] == i);
+        }
+    }
+}
+
+TEST_CASE("Submitted closures return results through futures")
+{
+    auto strand = rmx::Strand<int>(1);
+
+    std::future<int> result = strand.submit([](int& value) { return ++value; });
+    std::future<void> done = strand.submit([](int& value) { value *= 10; });
+    REQUIRE(result.get() == 2);
+    done.get();
+    REQUIRE(strand.submit([](int& value) { return value; }).get() == 20);
+}
+
+TEST_CASE("Exceptions poison the Strand")
+{
+    auto strand = rmx::Strand<int>(1);
+
+    auto failed = strand.submit([](int&) -> int { throw std::logic_error("oops"); });
+    REQUIRE_THROWS_AS(failed.get(), std::logic_error);
+    REQUIRE(strand.is_poisoned());
+    REQUIRE_THROWS_AS(strand.post([](int& value) { value++; }), std::runtime_error);
+    REQUIRE_THROWS_AS(strand.submit([](int& value) { return value; }), std::runtime_error);
+
+    strand.clear_poison();
+    strand.post([](int&) { throw std::logic_error("oops"); });
+    REQUIRE(strand.is_poisoned());
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <vector>
+
+TEST_CASE("Shadowed guards commit on scope exit")
+{
+    auto mutex = rmx::Mutex<std::vector<int>>({1, 2, 3});
+
+    {
+        auto value = mutex.lock_shadowed();
+        value->push_back(4);
+
+        INFO("Reads through the guard see the uncommitted changes");
+        REQUIRE(value->size() == 4);
+    }
+
+    auto value = mutex.lock();
+    REQUIRE(*value == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Shadowed guards roll back on exceptions")
+{
+    auto mutex = rmx::Mutex<std::vector<int>>({1, 2, 3});
+
+    try
+    {
+        auto value = mutex.lock_shadowed();
+        value->push_back(4);
+        throw std::runtime_error("Throwing an exception while the Mutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+
+    INFO("The Mutex isn't poisoned, and the value is unchanged");
+    REQUIRE_FALSE(mutex.is_poisoned());
+    auto value = mutex.lock();
+    REQUIRE(*value == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Shadowed guards can be rolled back manually")
+{
+    auto mutex = rmx::Mutex<std::vector<int>>({1, 2, 3});
+
+    {
+        auto value = mutex.lock_shadowed();
+        value->clear();
+        value.rollback();
+        REQUIRE(value->size() == 3);
+    }
+
+    auto value = mutex.lock();
+    REQUIRE(*value == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Transaction guards replay the undo log on exceptions")
+{
+    auto mutex = rmx::Mutex<std::vector<int>>({1, 2, 3});
+
+    {
+        auto value = mutex.lock_transaction();
+        value->push_back(4);
+        value.on_rollback([](std::vector<int>& v) { v.pop_back(); });
+    }
+
+    try
+    {
+        auto value = mutex.lock_transaction();
+        value->push_back(5);
+        value.on_rollback([](std::vector<int>& v) { v.pop_back(); });
+        (*value)[0] = 42;
+        value.on_rollback([](std::vector<int>& v) { v[0] = 1; });
+        throw std::runtime_error("Throwing an exception while the Mutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+
+    INFO("Only the transaction that threw was rolled back");
+    REQUIRE_FALSE(mutex.is_poisoned());
+    auto value = mutex.lock();
+    REQUIRE(*value == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("A failed rollback poisons the Mutex")
+{
+    auto mutex = rmx::Mutex<int>(1);
+
+    try
+    {
+        auto value = mutex.lock_transaction();
+        *value = 2;
+        value.on_rollback([](int&) { throw std::runtime_error("Can't undo"); });
+        throw std::runtime_error("Throwing an exception while the Mutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+
+    REQUIRE(mutex.is_poisoned());
+    REQUIRE_THROWS(mutex.lock_transaction());
+}
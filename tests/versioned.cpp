@@ -0,0 +1,137 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/rmx.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using VersionedMutex = rmx::Mutex<std::vector<int>, std::mutex, rmx::Compact, rmx::Versioned>;
+using VersionedRwLock =
+    rmx::Mutex<std::vector<int>, std::shared_mutex, rmx::Compact, rmx::Versioned>;
+
+TEST_CASE("Releasing a mutable guard bumps the version")
+{
+    VersionedMutex mutex;
+    REQUIRE(mutex.version() == 0);
+
+    {
+        auto guard = mutex.lock();
+        guard->push_back(1);
+        INFO("The version is bumped when the guard is released, not when it's acquired");
+        REQUIRE(mutex.version() == 0);
+    }
+    REQUIRE(mutex.version() == 1);
+
+    mutex.with([](std::vector<int>& value) { value.push_back(2); });
+    REQUIRE(mutex.try_lock().has_value());
+    REQUIRE(mutex.version() == 3);
+}
+
+TEST_CASE("Read guards don't bump the version")
+{
+    VersionedRwLock mutex;
+    mutex.lock()->push_back(1);
+    const std::uint64_t version = mutex.version();
+
+    const auto& shared = mutex;
+    REQUIRE(shared.lock()->size() == 1);
+    REQUIRE(shared.with([](const std::vector<int>& value) { return value.size(); }) == 1);
+    REQUIRE(mutex.version() == version);
+}
+
+TEST_CASE("Skip recomputing a derived value when the version hasn't changed")
+{
+    VersionedRwLock mutex(std::vector<int>{1, 2, 3});
+    const auto& shared = mutex;
+    int recomputed = 0;
+    std::uint64_t cached_version = ~std::uint64_t{0};
+    int cached_sum = 0;
+
+    auto sum = [&] {
+        if (mutex.version() != cached_version)
+        {
+            auto guard = shared.lock();
+            cached_version = mutex.version();
+            cached_sum = 0;
+            for (int value : *guard)
+            {
+                cached_sum += value;
+            }
+            recomputed++;
+        }
+        return cached_sum;
+    };
+
+    REQUIRE(sum() == 6);
+    REQUIRE(sum() == 6);
+    REQUIRE(recomputed == 1);
+
+    mutex.lock()->push_back(4);
+    REQUIRE(sum() == 10);
+    REQUIRE(recomputed == 2);
+}
+
+TEST_CASE("Shadowed guards only bump the version when they commit")
+{
+    VersionedMutex mutex;
+    {
+        auto guard = mutex.lock_shadowed();
+        guard->push_back(1);
+        guard.rollback();
+    }
+    REQUIRE(mutex.version() == 0);
+
+    try
+    {
+        auto guard = mutex.lock_shadowed();
+        guard->push_back(1);
+        throw std::runtime_error("Throwing an exception while the Mutex is locked");
+    } catch (...)
+    {
+        // ...
+    }
+    REQUIRE(mutex.version() == 0);
+
+    mutex.lock_shadowed()->push_back(1);
+    REQUIRE(mutex.version() == 1);
+
+    mutex.lock_transaction()->push_back(2);
+    REQUIRE(mutex.version() == 2);
+}
+
+TEST_CASE("Versioning is opt in")
+{
+    //! What an unversioned Mutex holds, written out by hand
+    struct Unversioned
+    {
+        std::mutex mutex;
+        int value;
+        bool was_poisoned;
+    };
+
+    INFO("An unversioned Mutex costs nothing beyond its storage");
+    STATIC_REQUIRE(sizeof(rmx::Mutex<int>) ==
+                   sizeof(rmx::detail::MutexStorage<int, std::mutex, rmx::Compact>));
+    STATIC_REQUIRE(sizeof(rmx::Mutex<int>) == sizeof(Unversioned));
+    STATIC_REQUIRE(sizeof(VersionedMutex) > sizeof(rmx::Mutex<std::vector<int>>));
+
+    //! What an unversioned MutexGuard holds, written out by hand
+    struct UnversionedGuard
+    {
+        virtual ~UnversionedGuard() = default;
+        std::unique_lock<std::mutex> lock;
+        std::reference_wrapper<int> value;
+        std::reference_wrapper<bool> was_poisoned;
+        int exceptions;
+    };
+
+    INFO("Guards on an unversioned Mutex don't carry a pointer to a change counter");
+    using Guard = decltype(std::declval<rmx::Mutex<int>&>().lock());
+    using VersionedGuard = decltype(std::declval<VersionedMutex&>().lock());
+    STATIC_REQUIRE(sizeof(Guard) == sizeof(UnversionedGuard));
+    STATIC_REQUIRE(sizeof(VersionedGuard) > sizeof(Guard));
+}
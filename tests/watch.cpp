@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <rmx/watch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Publishing a value bumps the version")
+{
+    rmx::Watch<std::string> watch("initial");
+    REQUIRE(watch.version() == 0);
+    REQUIRE(*watch.borrow() == "initial");
+
+    watch.publish("updated");
+    REQUIRE(watch.version() == 1);
+    REQUIRE(*watch.borrow() == "updated");
+
+    REQUIRE(watch.modify([](std::string& value) { return value.size(); }) == 7);
+    REQUIRE(watch.version() == 2);
+}
+
+TEST_CASE("Waiting returns immediately if the version already changed")
+{
+    rmx::Watch<int> watch(1);
+    const std::uint32_t seen = watch.version();
+    watch.publish(2);
+    REQUIRE(watch.wait_changed(seen) == seen + 1);
+    REQUIRE(watch.wait_changed_for(seen, std::chrono::seconds(1)) == seen + 1);
+}
+
+TEST_CASE("Waiting for a change times out")
+{
+    rmx::Watch<int> watch(1);
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(watch.wait_changed_for(watch.version(), std::chrono::milliseconds(20)) ==
+            std::nullopt);
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+}
+
+TEST_CASE("Every waiting reader wakes for a change")
+{
+    constexpr int readers = 8;
+    rmx::Watch<int> watch(0);
+    // Catch2 assertions aren't thread safe, so the readers only count what they saw
+    std::atomic<int> saw_initial{0};
+    std::atomic<int> ready{0};
+    std::atomic<int> saw_change{0};
+
+    std::vector<std::thread> pool;
+    for (int r = 0; r < readers; r++)
+    {
+        pool.emplace_back([&] {
+            std::uint32_t seen = 0;
+            {
+                auto value = watch.borrow();
+                seen = watch.version();
+                if (*value == 0)
+                {
+                    saw_initial++;
+                }
+            }
+            ready++;
+            watch.wait_changed(seen);
+            if (*watch.borrow() == 42)
+            {
+                saw_change++;
+            }
+        });
+    }
+    while (ready < readers)
+    {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    watch.publish(42);
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+    REQUIRE(saw_initial == readers);
+    REQUIRE(saw_change == readers);
+}
+
+TEST_CASE("A failed modification poisons the Watch, and still wakes readers")
+{
+    rmx::Watch<int> watch(1);
+    const std::uint32_t seen = watch.version();
+
+    bool borrow_threw = false;
+    int unchecked = 0;
+    std::thread reader([&, seen] {
+        watch.wait_changed(seen);
+        try
+        {
+            static_cast<void>(watch.borrow());
+        } catch (const std::runtime_error&)
+        {
+            borrow_threw = true;
+        }
+        unchecked = *watch.borrow_unchecked();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    auto fail = [](int& value) {
+        value = 2;
+        throw std::runtime_error("Throwing an exception while the Watch is locked");
+    };
+    REQUIRE_THROWS_AS(watch.modify(fail), std::runtime_error);
+    reader.join();
+    REQUIRE(borrow_threw);
+    REQUIRE(unchecked == 2);
+
+    REQUIRE(watch.is_poisoned());
+    REQUIRE_THROWS_AS(watch.publish(3), std::runtime_error);
+    watch.clear_poison();
+    watch.publish(3);
+    REQUIRE(*watch.borrow() == 3);
+}